@@ -7,20 +7,57 @@
 #include <algorithm>
 #include <limits>
 #include <sstream>
+#include <cstdint>
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 // Forward declarations
 class Player;
 class Team;
 class League;
+class ReportWriter;
 
 // Utility functions for input validation and display
 namespace Utility {
-    // Clear the console screen
+    // Clear the console screen (ANSI escape, so no shell is spawned)
     void clearScreen() {
         #ifdef _WIN32
             system("cls");
         #else
-            system("clear");
+            std::cout << "\033[2J\033[3J\033[H" << std::flush;
         #endif
     }
 
@@ -56,9 +93,9 @@ namespace Utility {
     // Display a centered title
     void displayTitle(const std::string& title) {
         int width = 60;
-        std::cout << std::string(width, '*') << std::endl;
-        std::cout << std::setw((width + title.length()) / 2) << title << std::endl;
-        std::cout << std::string(width, '*') << std::endl;
+        std::cout << std::string(width, '*') << '\n';
+        std::cout << std::setw((width + title.length()) / 2) << title << '\n';
+        std::cout << std::string(width, '*') << '\n';
     }
 
     // For formatting tables
@@ -70,974 +107,7445 @@ namespace Utility {
     }
 }
 
-// Enum for player positions
-enum class Position {
-    QUARTERBACK,
-    RUNNING_BACK,
-    WIDE_RECEIVER,
-    TIGHT_END,
-    KICKER,
-    DEFENSE
-};
+// Random number generation for the simulation
+namespace Random {
+    // SplitMix64 step, used to expand a single seed into engine state and to derive stream seeds
+    inline uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
 
-// Convert Position enum to string
-std::string positionToString(Position pos) {
-    switch (pos) {
-        case Position::QUARTERBACK: return "QB";
-        case Position::RUNNING_BACK: return "RB";
-        case Position::WIDE_RECEIVER: return "WR";
-        case Position::TIGHT_END: return "TE";
-        case Position::KICKER: return "K";
-        case Position::DEFENSE: return "DEF";
-        default: return "Unknown";
+    // Combine a base seed with a stream identifier (week, matchup index, ...)
+    inline uint64_t deriveSeed(uint64_t seed, uint64_t stream) {
+        uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        return splitMix64(state);
+    }
+
+    // xoshiro256** engine: 32 bytes of state, satisfies UniformRandomBitGenerator
+    class Engine {
+    private:
+        uint64_t s[4];
+        uint64_t draws;     // numbers produced since construction (reseeding keeps counting)
+
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        using result_type = uint64_t;
+
+        explicit Engine(uint64_t seedValue = 0x5EED5EED5EED5EEDULL) : draws(0) { seed(seedValue); }
+
+        void seed(uint64_t seedValue) {
+            uint64_t state = seedValue;
+            for (auto& word : s) {
+                word = splitMix64(state);
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        uint64_t getDraws() const { return draws; }
+
+        result_type operator()() {
+            draws++;
+            const uint64_t result = rotl(s[1] * 5, 7) * 9;
+            const uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+    };
+
+    // Per-thread engine. Seeded once from std::random_device unless seed() is called.
+    inline Engine& engine() {
+        thread_local Engine threadEngine(std::random_device{}() ^ (static_cast<uint64_t>(std::random_device{}()) << 32));
+        return threadEngine;
+    }
+
+    // Reseed the calling thread's engine so a run can be reproduced exactly
+    inline void seed(uint64_t seedValue) {
+        engine().seed(seedValue);
+    }
+    
+    // Draws the calling thread made from its own engines (a game's seeded stream, ...),
+    // added by their owners so trace scopes count them
+    inline uint64_t& localDraws() {
+        thread_local uint64_t count = 0;
+        return count;
     }
+    
+    // Every draw made on the calling thread
+    inline uint64_t threadDraws() {
+        return engine().getDraws() + localDraws();
+    }
+
+    // Reusable inclusive integer range. Unlike std::uniform_int_distribution it holds no
+    // state, so a single const instance can be shared, and it gives the same sequence on
+    // every standard library (multiply-shift range reduction).
+    class IntRange {
+    private:
+        int low;
+        uint64_t span;
+
+    public:
+        IntRange(int low, int high) : low(low), span(static_cast<uint64_t>(high - low) + 1) {}
+
+        int operator()(Engine& gen) const {
+            return low + static_cast<int>(((gen() >> 32) * span) >> 32);
+        }
+
+        int min() const { return low; }
+        int max() const { return low + static_cast<int>(span) - 1; }
+    };
 }
 
-// Player class to store player information and statistics
-class Player {
-private:
-    int id;
-    std::string name;
-    Position position;
-    std::string team;
+// Built-in tracing. Scopes record wall time plus the allocations and RNG draws made on
+// the recording thread into that thread's ring buffer; nothing is shared on the hot path.
+// When tracing is off a scope costs one relaxed load. Allocations are only counted in
+// builds with SPORTS_MANAGER_ALLOCATION_HOOK, which replaces the global operator new.
+namespace Trace {
+#ifdef SPORTS_MANAGER_ALLOCATION_HOOK
+    const bool COUNTS_ALLOCATIONS = true;
+#else
+    const bool COUNTS_ALLOCATIONS = false;
+#endif
     
-    // Player statistics
-    int gamesPlayed;
+    struct Event {
+        const char* name;       // string literal
+        uint64_t start;         // ns since the trace epoch
+        uint64_t duration;      // ns
+        uint64_t allocations;
+        uint64_t rngDraws;
+    };
+    
+    // Single-writer ring of the most recent events for one thread. Each slot is a seqlock:
+    // its sequence is odd while the writer fills it and 2 * (index + 1) once it holds event
+    // index, so a reader keeps exactly the slots that still hold the event it asked for.
+    // The fields are relaxed atomics, so reading a slot being rewritten is not a data race.
+    class RingBuffer {
+    public:
+        static const size_t CAPACITY = 1 << 16;
+        
+        explicit RingBuffer(uint32_t threadId) : slots(new Slot[CAPACITY]), head(0), threadId(threadId) {}
+        
+        void push(const Event& event) {
+            uint64_t index = head.load(std::memory_order_relaxed);
+            Slot& slot = slots[index & (CAPACITY - 1)];
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(event.name, std::memory_order_relaxed);
+            slot.start.store(event.start, std::memory_order_relaxed);
+            slot.duration.store(event.duration, std::memory_order_relaxed);
+            slot.allocations.store(event.allocations, std::memory_order_relaxed);
+            slot.rngDraws.store(event.rngDraws, std::memory_order_relaxed);
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+            head.store(index + 1, std::memory_order_release);
+        }
+        
+        // Copy out the retained events, oldest first, skipping any the writer overwrote
+        // while we read
+        void collect(std::vector<Event>& out) const {
+            uint64_t end = head.load(std::memory_order_acquire);
+            uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+            for (uint64_t i = begin; i < end; ++i) {
+                const Slot& slot = slots[i & (CAPACITY - 1)];
+                uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence != 2 * i + 2) {
+                    continue;
+                }
+                Event event{slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                            slot.duration.load(std::memory_order_relaxed), slot.allocations.load(std::memory_order_relaxed),
+                            slot.rngDraws.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                    out.push_back(event);
+                }
+            }
+        }
+        
+        void clear() { head.store(0, std::memory_order_release); }
+        uint32_t getThreadId() const { return threadId; }
     
-    // QB stats
-    int passingYards;
-    int passingTouchdowns;
-    int interceptions;
+    private:
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> start{0};
+            std::atomic<uint64_t> duration{0};
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> rngDraws{0};
+        };
+        
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head;
+        uint32_t threadId;
+    };
     
-    // RB/WR/TE stats
-    int rushingYards;
-    int rushingTouchdowns;
-    int receivingYards;
-    int receivingTouchdowns;
+    inline std::atomic<bool>& enabledFlag() {
+        static std::atomic<bool> flag(false);
+        return flag;
+    }
     
-    // K stats
-    int fieldGoals;
-    int extraPoints;
+    inline bool enabled() {
+        return enabledFlag().load(std::memory_order_relaxed);
+    }
     
-    // DEF stats
-    int sacks;
-    int defensiveInterceptions;
-    int defensiveTouchdowns;
+    inline void enable(bool on) {
+        enabledFlag().store(on, std::memory_order_relaxed);
+    }
     
-    // Fantasy points
-    double fantasyPoints;
-
-public:
-    Player(int id, const std::string& name, Position position, const std::string& team)
-        : id(id), name(name), position(position), team(team),
-          gamesPlayed(0), passingYards(0), passingTouchdowns(0), interceptions(0),
-          rushingYards(0), rushingTouchdowns(0), receivingYards(0), receivingTouchdowns(0),
-          fieldGoals(0), extraPoints(0), sacks(0), defensiveInterceptions(0), defensiveTouchdowns(0),
-          fantasyPoints(0.0) {}
+    inline uint64_t now() {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
     
-    // Getters
-    int getId() const { return id; }
-    std::string getName() const { return name; }
-    Position getPosition() const { return position; }
-    std::string getTeam() const { return team; }
-    double getFantasyPoints() const { return fantasyPoints; }
+    // Every thread's buffer; only touched when a thread records its first event and on export
+    struct BufferList {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<RingBuffer>> buffers;
+    };
     
-    // Simulate a game performance based on position
-    void simulateGamePerformance() {
-        gamesPlayed++;
-        
-        // Random engine
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        
-        // Reset game stats before simulation
-        double gamePoints = 0.0;
-        
-        switch (position) {
-            case Position::QUARTERBACK: {
-                // Passing yards (150-400)
-                std::uniform_int_distribution<> passYards(150, 400);
-                int gamePassingYards = passYards(gen);
-                passingYards += gamePassingYards;
-                gamePoints += gamePassingYards * 0.04; // 0.04 points per passing yard
-                
-                // Passing TDs (0-4)
-                std::uniform_int_distribution<> passTDs(0, 4);
-                int gamePassingTDs = passTDs(gen);
-                passingTouchdowns += gamePassingTDs;
-                gamePoints += gamePassingTDs * 4.0; // 4 points per TD
-                
-                // Interceptions (0-3)
-                std::uniform_int_distribution<> ints(0, 3);
-                int gameInterceptions = ints(gen);
-                interceptions += gameInterceptions;
-                gamePoints -= gameInterceptions * 2.0; // -2 points per interception
-                
-                // Rushing yards for QB (0-50)
-                std::uniform_int_distribution<> qbRush(0, 50);
-                int gameRushingYards = qbRush(gen);
-                rushingYards += gameRushingYards;
-                gamePoints += gameRushingYards * 0.1; // 0.1 points per rushing yard
-                
-                // Rushing TDs (0-1)
-                std::uniform_int_distribution<> qbRushTDs(0, 1);
-                int gameRushingTDs = qbRushTDs(gen);
-                rushingTouchdowns += gameRushingTDs;
-                gamePoints += gameRushingTDs * 6.0; // 6 points per rushing TD
-                break;
-            }
-            case Position::RUNNING_BACK: {
-                // Rushing yards (30-150)
-                std::uniform_int_distribution<> rushYards(30, 150);
-                int gameRushingYards = rushYards(gen);
-                rushingYards += gameRushingYards;
-                gamePoints += gameRushingYards * 0.1; // 0.1 points per rushing yard
-                
-                // Rushing TDs (0-2)
-                std::uniform_int_distribution<> rushTDs(0, 2);
-                int gameRushingTDs = rushTDs(gen);
-                rushingTouchdowns += gameRushingTDs;
-                gamePoints += gameRushingTDs * 6.0; // 6 points per rushing TD
-                
-                // Receiving yards (0-50)
-                std::uniform_int_distribution<> recYards(0, 50);
-                int gameReceivingYards = recYards(gen);
-                receivingYards += gameReceivingYards;
-                gamePoints += gameReceivingYards * 0.1; // 0.1 points per receiving yard
-                
-                // Receiving TDs (0-1)
-                std::uniform_int_distribution<> recTDs(0, 1);
-                int gameReceivingTDs = recTDs(gen);
-                receivingTouchdowns += gameReceivingTDs;
-                gamePoints += gameReceivingTDs * 6.0; // 6 points per receiving TD
-                break;
-            }
-            case Position::WIDE_RECEIVER: {
-                // Receiving yards (20-150)
-                std::uniform_int_distribution<> recYards(20, 150);
-                int gameReceivingYards = recYards(gen);
-                receivingYards += gameReceivingYards;
-                gamePoints += gameReceivingYards * 0.1; // 0.1 points per receiving yard
-                
-                // Receiving TDs (0-2)
-                std::uniform_int_distribution<> recTDs(0, 2);
-                int gameReceivingTDs = recTDs(gen);
-                receivingTouchdowns += gameReceivingTDs;
-                gamePoints += gameReceivingTDs * 6.0; // 6 points per receiving TD
-                break;
-            }
-            case Position::TIGHT_END: {
-                // Receiving yards (10-100)
-                std::uniform_int_distribution<> recYards(10, 100);
-                int gameReceivingYards = recYards(gen);
-                receivingYards += gameReceivingYards;
-                gamePoints += gameReceivingYards * 0.1; // 0.1 points per receiving yard
-                
-                // Receiving TDs (0-1)
-                std::uniform_int_distribution<> recTDs(0, 1);
-                int gameReceivingTDs = recTDs(gen);
-                receivingTouchdowns += gameReceivingTDs;
-                gamePoints += gameReceivingTDs * 6.0; // 6 points per receiving TD
-                break;
-            }
-            case Position::KICKER: {
-                // Field goals (0-5)
-                std::uniform_int_distribution<> fg(0, 5);
-                int gameFieldGoals = fg(gen);
-                fieldGoals += gameFieldGoals;
-                gamePoints += gameFieldGoals * 3.0; // 3 points per field goal
-                
-                // Extra points (1-5)
-                std::uniform_int_distribution<> xp(1, 5);
-                int gameExtraPoints = xp(gen);
-                extraPoints += gameExtraPoints;
-                gamePoints += gameExtraPoints * 1.0; // 1 point per extra point
-                break;
+    inline BufferList& bufferList() {
+        static BufferList* list = new BufferList();   // outlives threads exiting during shutdown
+        return *list;
+    }
+    
+    inline RingBuffer& threadBuffer() {
+        thread_local std::shared_ptr<RingBuffer> buffer = [] {
+            BufferList& list = bufferList();
+            std::lock_guard<std::mutex> lock(list.mutex);
+            list.buffers.push_back(std::make_shared<RingBuffer>(static_cast<uint32_t>(list.buffers.size() + 1)));
+            return list.buffers.back();
+        }();
+        return *buffer;
+    }
+    
+    // Heap allocations made by the calling thread (counted by the global operator new when
+    // the allocation hook is built in, otherwise always 0)
+    inline uint64_t& allocationCount() {
+        thread_local uint64_t count = 0;
+        return count;
+    }
+    
+    // Records one event covering its lifetime, if tracing was on when it started
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name(name), start(0) {
+            if (enabled()) {
+                allocations = allocationCount();
+                rngDraws = Random::threadDraws();
+                start = now();
             }
-            case Position::DEFENSE: {
-                // Sacks (0-5)
-                std::uniform_int_distribution<> sackDist(0, 5);
-                int gameSacks = sackDist(gen);
-                sacks += gameSacks;
-                gamePoints += gameSacks * 1.0; // 1 point per sack
-                
-                // Interceptions (0-3)
-                std::uniform_int_distribution<> intDist(0, 3);
-                int gameDefInterceptions = intDist(gen);
-                defensiveInterceptions += gameDefInterceptions;
-                gamePoints += gameDefInterceptions * 2.0; // 2 points per interception
-                
-                // Defensive TDs (0-1)
-                std::uniform_int_distribution<> defTD(0, 1);
-                int gameDefTDs = defTD(gen);
-                defensiveTouchdowns += gameDefTDs;
-                gamePoints += gameDefTDs * 6.0; // 6 points per defensive TD
-                
-                // Points allowed (0-35)
-                std::uniform_int_distribution<> ptsAllowed(0, 35);
-                int pointsAllowed = ptsAllowed(gen);
-                
-                // Points based on points allowed
-                if (pointsAllowed == 0) gamePoints += 10.0;
-                else if (pointsAllowed <= 6) gamePoints += 7.0;
-                else if (pointsAllowed <= 13) gamePoints += 4.0;
-                else if (pointsAllowed <= 20) gamePoints += 1.0;
-                else if (pointsAllowed <= 27) gamePoints += 0.0;
-                else if (pointsAllowed <= 34) gamePoints -= 1.0;
-                else gamePoints -= 4.0;
-                break;
+        }
+        
+        ~Scope() {
+            if (start != 0) {
+                uint64_t end = now();
+                threadBuffer().push({name, start, end - start, allocationCount() - allocations,
+                                     Random::threadDraws() - rngDraws});
             }
         }
         
-        // Update total fantasy points
-        fantasyPoints += gamePoints;
-    }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
     
-    // Display player information
-    void displayInfo() const {
-        std::cout << std::left << std::setw(4) << id << " | "
-                  << std::setw(20) << name << " | "
-                  << std::setw(5) << positionToString(position) << " | "
-                  << std::setw(15) << team << " | "
-                  << std::fixed << std::setprecision(1) << std::setw(8) << fantasyPoints << std::endl;
-    }
+    private:
+        const char* name;
+        uint64_t start;
+        uint64_t allocations = 0;
+        uint64_t rngDraws = 0;
+    };
     
-    // Display detailed player statistics
-    void displayDetailedStats() const {
-        std::cout << "\n===== " << name << " (" << positionToString(position) << ", " << team << ") =====\n";
-        std::cout << "Games Played: " << gamesPlayed << std::endl;
-        std::cout << "Fantasy Points: " << std::fixed << std::setprecision(1) << fantasyPoints << std::endl;
-        
-        switch (position) {
-            case Position::QUARTERBACK:
-                std::cout << "Passing Yards: " << passingYards << std::endl;
-                std::cout << "Passing TDs: " << passingTouchdowns << std::endl;
-                std::cout << "Interceptions: " << interceptions << std::endl;
-                std::cout << "Rushing Yards: " << rushingYards << std::endl;
-                std::cout << "Rushing TDs: " << rushingTouchdowns << std::endl;
-                break;
-            case Position::RUNNING_BACK:
-                std::cout << "Rushing Yards: " << rushingYards << std::endl;
-                std::cout << "Rushing TDs: " << rushingTouchdowns << std::endl;
-                std::cout << "Receiving Yards: " << receivingYards << std::endl;
-                std::cout << "Receiving TDs: " << receivingTouchdowns << std::endl;
-                break;
-            case Position::WIDE_RECEIVER:
-            case Position::TIGHT_END:
-                std::cout << "Receiving Yards: " << receivingYards << std::endl;
-                std::cout << "Receiving TDs: " << receivingTouchdowns << std::endl;
-                break;
-            case Position::KICKER:
-                std::cout << "Field Goals: " << fieldGoals << std::endl;
-                std::cout << "Extra Points: " << extraPoints << std::endl;
-                break;
-            case Position::DEFENSE:
-                std::cout << "Sacks: " << sacks << std::endl;
-                std::cout << "Interceptions: " << defensiveInterceptions << std::endl;
-                std::cout << "Defensive TDs: " << defensiveTouchdowns << std::endl;
-                break;
+    // Discard everything recorded so far (while no other thread is recording)
+    inline void clear() {
+        BufferList& list = bufferList();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        for (auto& buffer : list.buffers) {
+            buffer->clear();
         }
     }
-};
+    
+    void exportChromeTrace(std::ostream& out);
+    void writeSummary(ReportWriter& report);
+}
 
-// Team class to store team information and roster
-class Team {
-private:
-    std::string name;
-    std::string owner;
-    std::vector<Player*> roster;
-    std::vector<Player*> activeLineup;
-    int wins;
-    int losses;
-    double totalPoints;
+#ifdef SPORTS_MANAGER_ALLOCATION_HOOK
+// Count heap allocations per thread for Trace scopes. Every non-aligned form is replaced,
+// so no allocation from the library's own operator new reaches these deletes.
+// (GCC sees malloc/free through the inlined replacements and misreports a mismatch)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+    Trace::allocationCount()++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
 
-public:
-    Team(const std::string& name, const std::string& owner)
-        : name(name), owner(owner), wins(0), losses(0), totalPoints(0.0) {}
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    Trace::allocationCount()++;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// Typed object pool. Objects live in fixed-size chunks, so pointers stay valid for the
+// pool's lifetime; destroyed slots go on a free list and are reused by the next create().
+// Destroying the pool releases every chunk at once.
+template <typename T, size_t ChunkSize = 256>
+class ObjectPool {
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
     
-    // Getters
-    std::string getName() const { return name; }
-    std::string getOwner() const { return owner; }
-    int getWins() const { return wins; }
-    int getLosses() const { return losses; }
-    double getTotalPoints() const { return totalPoints; }
+    struct Chunk {
+        Slot slots[ChunkSize];
+        bool live[ChunkSize];
+    };
     
-    // Add a player to the roster
-    bool addPlayer(Player* player) {
-        // Check if player is already on the roster
-        for (const auto& p : roster) {
-            if (p->getId() == player->getId()) {
-                return false;
-            }
-        }
-        roster.push_back(player);
-        return true;
-    }
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    Slot* freeList;
+    size_t used;        // slots handed out from the newest chunk
+    size_t liveCount;
     
-    // Remove a player from the roster
-    bool removePlayer(int playerId) {
-        for (auto it = roster.begin(); it != roster.end(); ++it) {
-            if ((*it)->getId() == playerId) {
-                // Also remove from active lineup if present
-                for (auto lit = activeLineup.begin(); lit != activeLineup.end(); ++lit) {
-                    if ((*lit)->getId() == playerId) {
-                        activeLineup.erase(lit);
-                        break;
-                    }
-                }
-                roster.erase(it);
+    // Find the chunk and index of a slot (chunks are few, so a linear scan is fine)
+    bool locate(const Slot* slot, Chunk*& chunk, size_t& index) const {
+        for (const auto& c : chunks) {
+            if (slot >= c->slots && slot < c->slots + ChunkSize) {
+                chunk = c.get();
+                index = static_cast<size_t>(slot - c->slots);
                 return true;
             }
         }
         return false;
     }
+
+public:
+    ObjectPool() : freeList(nullptr), used(ChunkSize), liveCount(0) {}
     
-    // Display team roster
-    void displayRoster() const {
-        Utility::displayTitle("TEAM ROSTER: " + name + " (Owner: " + owner + ")");
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(5) << "Pos" << " | "
-                  << std::setw(15) << "Team" << " | "
-                  << std::setw(8) << "Points" << std::endl;
-        std::cout << std::string(60, '-') << std::endl;
-        
-        for (const auto& player : roster) {
-            player->displayInfo();
-        }
-        
-        std::cout << "\nTeam Record: " << wins << "-" << losses << std::endl;
-        std::cout << "Total Points: " << std::fixed << std::setprecision(1) << totalPoints << std::endl;
+    ~ObjectPool() {
+        clear();
     }
     
-    // Set active lineup
-    bool setLineup(const std::vector<int>& playerIds) {
-        activeLineup.clear();
-        
-        for (int id : playerIds) {
-            bool found = false;
-            for (auto& player : roster) {
-                if (player->getId() == id) {
-                    activeLineup.push_back(player);
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                return false; // Player ID not found in roster
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return chunks.size() * ChunkSize; }
+    
+    // Construct an object in a free slot
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot;
+        Chunk* chunk = nullptr;
+        size_t index = 0;
+        if (freeList) {
+            slot = freeList;
+            freeList = freeList->next;
+            locate(slot, chunk, index);
+        } else {
+            if (used == ChunkSize) {
+                chunks.push_back(std::unique_ptr<Chunk>(new Chunk()));
+                used = 0;
             }
+            chunk = chunks.back().get();
+            index = used++;
+            slot = &chunk->slots[index];
         }
-        
-        return true;
+        T* object = new (slot->storage) T(std::forward<Args>(args)...);
+        chunk->live[index] = true;
+        liveCount++;
+        return object;
     }
     
-    // Display active lineup
-    void displayLineup() const {
-        Utility::displayTitle("ACTIVE LINEUP: " + name + " (Owner: " + owner + ")");
-        
-        if (activeLineup.empty()) {
-            std::cout << "No active lineup set.\n";
+    // Destroy one object and make its slot available for reuse
+    void destroy(T* object) {
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        Chunk* chunk;
+        size_t index;
+        if (!object || !locate(slot, chunk, index) || !chunk->live[index]) {
             return;
         }
-        
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(5) << "Pos" << " | "
-                  << std::setw(15) << "Team" << " | "
-                  << std::setw(8) << "Points" << std::endl;
-        std::cout << std::string(60, '-') << std::endl;
-        
-        for (const auto& player : activeLineup) {
-            player->displayInfo();
-        }
+        object->~T();
+        chunk->live[index] = false;
+        slot->next = freeList;
+        freeList = slot;
+        liveCount--;
     }
     
-    // Simulate a game performance for all players in active lineup
-    double simulateGame() {
-        double gameScore = 0.0;
-        
-        for (auto& player : activeLineup) {
-            player->simulateGamePerformance();
-            gameScore += player->getFantasyPoints();
+    // Destroy every live object and free all chunks
+    void clear() {
+        for (auto& chunk : chunks) {
+            for (size_t i = 0; i < ChunkSize; ++i) {
+                if (chunk->live[i]) {
+                    reinterpret_cast<T*>(chunk->slots[i].storage)->~T();
+                }
+            }
         }
-        
-        // Add the game score to total points
-        totalPoints += gameScore;
-        
-        return gameScore;
+        chunks.clear();
+        freeList = nullptr;
+        used = ChunkSize;
+        liveCount = 0;
     }
+};
+
+// Open-addressing hash map keyed by player ID (linear probing, power-of-two capacity).
+// Slots live in one flat array, so a lookup is a hash and a short probe in cache. The two
+// smallest ints mark empty and deleted slots: they are never found and cannot be inserted.
+template <typename V>
+class IdMap {
+private:
+    static const int EMPTY = std::numeric_limits<int>::min();
+    static const int DELETED = std::numeric_limits<int>::min() + 1;
     
-    // Update team record
-    void updateRecord(bool isWin) {
-        if (isWin) {
-            wins++;
-        } else {
-            losses++;
-        }
-    }
+    struct Slot {
+        int key;
+        V value;
+    };
     
-    // Get roster size
-    int getRosterSize() const {
-        return roster.size();
+    std::vector<Slot> slots;
+    size_t count;
+    size_t occupied;    // live entries plus tombstones
+    
+    static size_t hash(int key) {
+        uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(x ^ (x >> 32));
     }
     
-    // Get lineup size
-    int getLineupSize() const {
-        return activeLineup.size();
+    static bool isReserved(int key) {
+        return key == EMPTY || key == DELETED;
     }
     
-    // Get player by ID from the roster
-    Player* getPlayerById(int id) {
-        for (auto& player : roster) {
-            if (player->getId() == id) {
-                return player;
+    size_t findSlot(int key) const {
+        if (slots.empty() || isReserved(key)) {
+            return SIZE_MAX;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return i;
+            }
+            if (slots[i].key == EMPTY) {
+                return SIZE_MAX;
             }
         }
-        return nullptr;
     }
     
-    // Get all players
-    const std::vector<Player*>& getRoster() const {
-        return roster;
-    }
-    
-    // Get active lineup
-    const std::vector<Player*>& getActiveLineup() const {
-        return activeLineup;
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(capacity, Slot{EMPTY, V()});
+        count = 0;
+        occupied = 0;
+        for (auto& slot : old) {
+            if (!isReserved(slot.key)) {
+                insert(slot.key, slot.value);
+            }
+        }
     }
-};
-
-// Matchup class to represent a game between two teams
-class Matchup {
-private:
-    Team* homeTeam;
-    Team* awayTeam;
-    double homeScore;
-    double awayScore;
-    bool isCompleted;
 
 public:
-    Matchup(Team* home, Team* away)
-        : homeTeam(home), awayTeam(away), homeScore(0.0), awayScore(0.0), isCompleted(false) {}
+    IdMap() : count(0), occupied(0) {}
     
-    // Simulate the matchup
-    void simulate() {
-        if (homeTeam->getLineupSize() == 0 || awayTeam->getLineupSize() == 0) {
-            std::cout << "Warning: One or both teams don't have an active lineup. Skipping matchup.\n";
-            return;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    void clear() {
+        slots.clear();
+        count = 0;
+        occupied = 0;
+    }
+    
+    // Pre-size for the expected number of entries
+    void reserve(size_t entries) {
+        size_t capacity = 16;
+        while (capacity * 3 < entries * 4) {
+            capacity *= 2;
         }
-        
-        homeScore = homeTeam->simulateGame();
-        awayScore = awayTeam->simulateGame();
-        
-        // Update team records
-        if (homeScore > awayScore) {
-            homeTeam->updateRecord(true);
-            awayTeam->updateRecord(false);
-        } else if (awayScore > homeScore) {
-            homeTeam->updateRecord(false);
-            awayTeam->updateRecord(true);
-        } else {
-            // In case of a tie, give both teams a loss (to keep it simple)
-            homeTeam->updateRecord(false);
-            awayTeam->updateRecord(false);
+        if (capacity > slots.size()) {
+            rehash(capacity);
         }
-        
-        isCompleted = true;
     }
     
-    // Display matchup results
-    void displayResults() const {
-        std::cout << "\n==== MATCHUP RESULTS ====\n";
-        std::cout << homeTeam->getName() << " vs " << awayTeam->getName() << std::endl;
-        
-        if (isCompleted) {
-            std::cout << "Score: " << std::fixed << std::setprecision(1) 
-                      << homeScore << " - " << awayScore << std::endl;
-            
-            if (homeScore > awayScore) {
-                std::cout << homeTeam->getName() << " wins!\n";
-            } else if (awayScore > homeScore) {
-                std::cout << awayTeam->getName() << " wins!\n";
-            } else {
-                std::cout << "It's a tie!\n";
+    V* find(int key) {
+        size_t i = findSlot(key);
+        return i == SIZE_MAX ? nullptr : &slots[i].value;
+    }
+    
+    const V* find(int key) const {
+        size_t i = findSlot(key);
+        return i == SIZE_MAX ? nullptr : &slots[i].value;
+    }
+    
+    bool contains(int key) const { return findSlot(key) != SIZE_MAX; }
+    
+    // Insert a new entry; returns false if the key is already present
+    bool insert(int key, const V& value) {
+        if (isReserved(key)) {
+            return false;
+        }
+        if ((occupied + 1) * 4 > slots.size() * 3) {
+            rehash(std::max<size_t>(16, count * 2 >= slots.size() ? slots.size() * 2 : slots.size()));
+        }
+        size_t mask = slots.size() - 1;
+        size_t tombstone = SIZE_MAX;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return false;
+            }
+            if (slots[i].key == DELETED && tombstone == SIZE_MAX) {
+                tombstone = i;
+            } else if (slots[i].key == EMPTY) {
+                if (tombstone != SIZE_MAX) {
+                    i = tombstone;
+                } else {
+                    occupied++;
+                }
+                slots[i].key = key;
+                slots[i].value = value;
+                count++;
+                return true;
             }
-        } else {
-            std::cout << "Matchup not yet simulated.\n";
         }
     }
     
-    // Getters
-    Team* getHomeTeam() const { return homeTeam; }
-    Team* getAwayTeam() const { return awayTeam; }
-    double getHomeScore() const { return homeScore; }
-    double getAwayScore() const { return awayScore; }
-    bool getIsCompleted() const { return isCompleted; }
+    bool erase(int key) {
+        size_t i = findSlot(key);
+        if (i == SIZE_MAX) {
+            return false;
+        }
+        slots[i].key = DELETED;
+        slots[i].value = V();
+        count--;
+        return true;
+    }
+    
+    // Call fn(key, value) for every entry
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const auto& slot : slots) {
+            if (!isReserved(slot.key)) {
+                fn(slot.key, slot.value);
+            }
+        }
+    }
 };
 
-// League class to manage teams, players, and matchups
-class League {
+// Deduplicated string storage. Interned strings never move, so callers can keep pointers.
+class StringInterner {
 private:
-    std::string name;
-    std::vector<Team*> teams;
-    std::vector<Player*> availablePlayers;
-    std::vector<Matchup*> schedule;
-    int currentWeek;
-    int maxTeams;
-    int rosterSize;
-    int lineupSize;
+    std::unordered_set<std::string> strings;
 
 public:
-    League(const std::string& name, int maxTeams, int rosterSize, int lineupSize)
-        : name(name), currentWeek(1), maxTeams(maxTeams), rosterSize(rosterSize), lineupSize(lineupSize) {
-        // Initialize available players with hard-coded data
-        initializePlayers();
+    const std::string* intern(const std::string& value) {
+        return &*strings.insert(value).first;
     }
     
-    ~League() {
-        // Cleanup memory
-        for (auto& team : teams) {
-            delete team;
-        }
-        for (auto& player : availablePlayers) {
-            delete player;
-        }
-        for (auto& matchup : schedule) {
-            delete matchup;
+    const std::string* intern(std::string_view value) {
+        auto it = strings.find(std::string(value));
+        if (it != strings.end()) {
+            return &*it;
         }
+        return &*strings.emplace(value).first;
     }
     
-    // Initialize players with hard-coded data
-    void initializePlayers() {
-        // Quarterbacks
-        availablePlayers.push_back(new Player(1, "Patrick Mahomes", Position::QUARTERBACK, "Kansas City"));
-        availablePlayers.push_back(new Player(2, "Josh Allen", Position::QUARTERBACK, "Buffalo"));
-        availablePlayers.push_back(new Player(3, "Lamar Jackson", Position::QUARTERBACK, "Baltimore"));
-        availablePlayers.push_back(new Player(4, "Joe Burrow", Position::QUARTERBACK, "Cincinnati"));
-        availablePlayers.push_back(new Player(5, "Justin Herbert", Position::QUARTERBACK, "Los Angeles"));
-        availablePlayers.push_back(new Player(6, "Jalen Hurts", Position::QUARTERBACK, "Philadelphia"));
-        
-        // Running Backs
-        availablePlayers.push_back(new Player(7, "Christian McCaffrey", Position::RUNNING_BACK, "San Francisco"));
-        availablePlayers.push_back(new Player(8, "Derrick Henry", Position::RUNNING_BACK, "Tennessee"));
-        availablePlayers.push_back(new Player(9, "Jonathan Taylor", Position::RUNNING_BACK, "Indianapolis"));
-        availablePlayers.push_back(new Player(10, "Nick Chubb", Position::RUNNING_BACK, "Cleveland"));
-        availablePlayers.push_back(new Player(11, "Saquon Barkley", Position::RUNNING_BACK, "New York"));
-        availablePlayers.push_back(new Player(12, "Austin Ekeler", Position::RUNNING_BACK, "Los Angeles"));
-        availablePlayers.push_back(new Player(13, "Alvin Kamara", Position::RUNNING_BACK, "New Orleans"));
-        availablePlayers.push_back(new Player(14, "Dalvin Cook", Position::RUNNING_BACK, "Minnesota"));
-        
-        // Wide Receivers
-        availablePlayers.push_back(new Player(15, "Justin Jefferson", Position::WIDE_RECEIVER, "Minnesota"));
-        availablePlayers.push_back(new Player(16, "Tyreek Hill", Position::WIDE_RECEIVER, "Miami"));
-        availablePlayers.push_back(new Player(17, "Davante Adams", Position::WIDE_RECEIVER, "Las Vegas"));
-        availablePlayers.push_back(new Player(18, "Cooper Kupp", Position::WIDE_RECEIVER, "Los Angeles"));
-        availablePlayers.push_back(new Player(19, "Stefon Diggs", Position::WIDE_RECEIVER, "Buffalo"));
-        availablePlayers.push_back(new Player(20, "CeeDee Lamb", Position::WIDE_RECEIVER, "Dallas"));
-        availablePlayers.push_back(new Player(21, "A.J. Brown", Position::WIDE_RECEIVER, "Philadelphia"));
-        availablePlayers.push_back(new Player(22, "Ja'Marr Chase", Position::WIDE_RECEIVER, "Cincinnati"));
-        availablePlayers.push_back(new Player(23, "Deebo Samuel", Position::WIDE_RECEIVER, "San Francisco"));
-        availablePlayers.push_back(new Player(24, "Mike Evans", Position::WIDE_RECEIVER, "Tampa Bay"));
-        
-        // Tight Ends
-        availablePlayers.push_back(new Player(25, "Travis Kelce", Position::TIGHT_END, "Kansas City"));
-        availablePlayers.push_back(new Player(26, "Mark Andrews", Position::TIGHT_END, "Baltimore"));
-        availablePlayers.push_back(new Player(27, "George Kittle", Position::TIGHT_END, "San Francisco"));
-        availablePlayers.push_back(new Player(28, "T.J. Hockenson", Position::TIGHT_END, "Detroit"));
-        availablePlayers.push_back(new Player(29, "Dallas Goedert", Position::TIGHT_END, "Philadelphia"));
-        
-        // Kickers
-        availablePlayers.push_back(new Player(30, "Justin Tucker", Position::KICKER, "Baltimore"));
-        availablePlayers.push_back(new Player(31, "Harrison Butker", Position::KICKER, "Kansas City"));
-        availablePlayers.push_back(new Player(32, "Evan McPherson", Position::KICKER, "Cincinnati"));
-        availablePlayers.push_back(new Player(33, "Tyler Bass", Position::KICKER, "Buffalo"));
-        
-        // Defenses
-        availablePlayers.push_back(new Player(34, "San Francisco 49ers", Position::DEFENSE, "San Francisco"));
-        availablePlayers.push_back(new Player(35, "Dallas Cowboys", Position::DEFENSE, "Dallas"));
-        availablePlayers.push_back(new Player(36, "Buffalo Bills", Position::DEFENSE, "Buffalo"));
-        availablePlayers.push_back(new Player(37, "New England Patriots", Position::DEFENSE, "New England"));
-        availablePlayers.push_back(new Player(38, "Pittsburgh Steelers", Position::DEFENSE, "Pittsburgh"));
-    }
+    size_t size() const { return strings.size(); }
+};
+
+// Appends compact JSON to a string. Commas between members and elements are inserted
+// automatically; numbers are formatted with std::to_chars.
+class JsonWriter {
+private:
+    std::string& out;
+    std::vector<bool> firstAtLevel;
+    bool afterKey;
     
-    // Register a new team
-    bool registerTeam(const std::string& teamName, const std::string& ownerName) {
-        if (teams.size() >= maxTeams) {
-            std::cout << "Maximum number of teams reached.\n";
-            return false;
+    void separator() {
+        if (afterKey) {
+            afterKey = false;
+            return;
         }
-        
-        // Check if team name is already taken
-        for (const auto& team : teams) {
-            if (team->getName() == teamName) {
-                std::cout << "Team name already exists. Please choose another name.\n";
-                return false;
+        if (!firstAtLevel.empty()) {
+            if (!firstAtLevel.back()) {
+                out += ',';
             }
+            firstAtLevel.back() = false;
         }
-        
-        teams.push_back(new Team(teamName, ownerName));
-        std::cout << "Team \"" << teamName << "\" successfully registered!\n";
-        return true;
     }
     
-    // Display all teams
-    void displayTeams() const {
-        Utility::displayTitle("TEAMS");
-        
-        if (teams.empty()) {
-            std::cout << "No teams registered yet.\n";
-            return;
-        }
-        
-        std::cout << std::left << std::setw(5) << "No." << " | "
-                  << std::setw(20) << "Team" << " | "
-                  << std::setw(20) << "Owner" << " | "
-                  << std::setw(10) << "Record" << " | "
-                  << std::setw(10) << "Points" << std::endl;
-        std::cout << std::string(70, '-') << std::endl;
-        
-        for (size_t i = 0; i < teams.size(); ++i) {
-            std::cout << std::left << std::setw(5) << (i + 1) << " | "
-                      << std::setw(20) << teams[i]->getName() << " | "
-                      << std::setw(20) << teams[i]->getOwner() << " | "
-                      << std::setw(10) << teams[i]->getWins() << "-" << teams[i]->getLosses() << " | "
-                      << std::fixed << std::setprecision(1) << std::setw(10) << teams[i]->getTotalPoints() << std::endl;
-        }
+    void open(char bracket) {
+        separator();
+        out += bracket;
+        firstAtLevel.push_back(true);
     }
     
-    // Display available players
-    void displayAvailablePlayers() const {
-        Utility::displayTitle("AVAILABLE PLAYERS");
-        
-        if (availablePlayers.empty()) {
-            std::cout << "No available players.\n";
-            return;
-        }
-        
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(5) << "Pos" << " | "
-                  << std::setw(15) << "Team" << std::endl;
-        std::cout << std::string(50, '-') << std::endl;
-        
-        for (const auto& player : availablePlayers) {
-            std::cout << std::left << std::setw(4) << player->getId() << " | "
-                      << std::setw(20) << player->getName() << " | "
-                      << std::setw(5) << positionToString(player->getPosition()) << " | "
-                      << std::setw(15) << player->getTeam() << std::endl;
-        }
+    void close(char bracket) {
+        out += bracket;
+        firstAtLevel.pop_back();
     }
+
+public:
+    explicit JsonWriter(std::string& out) : out(out), afterKey(false) {}
     
-    // Display players by position
-    void displayPlayersByPosition(Position pos) const {
-        std::string posStr = positionToString(pos);
-        Utility::displayTitle("AVAILABLE " + posStr + "s");
-        
-        bool foundPlayers = false;
-        
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(15) << "Team" << std::endl;
-        std::cout << std::string(45, '-') << std::endl;
-        
-        for (const auto& player : availablePlayers) {
-            if (player->getPosition() == pos) {
-                std::cout << std::left << std::setw(4) << player->getId() << " | "
-                          << std::setw(20) << player->getName() << " | "
-                          << std::setw(15) << player->getTeam() << std::endl;
-                foundPlayers = true;
+    // Append a quoted, escaped JSON string
+    static void appendString(std::string& out, std::string_view text) {
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char code[7];
+                        std::snprintf(code, sizeof(code), "\\u%04x", c);
+                        out += code;
+                    } else {
+                        out += c;
+                    }
             }
         }
-        
-        if (!foundPlayers) {
-            std::cout << "No available players at position " << posStr << ".\n";
-        }
+        out += '"';
     }
     
-    // Draft a player to a team
-    bool draftPlayer(Team* team, int playerId) {
-        // Find the player in available players
-        auto it = std::find_if(availablePlayers.begin(), availablePlayers.end(),
-                              [playerId](const Player* p) { return p->getId() == playerId; });
-        
-        if (it == availablePlayers.end()) {
-            std::cout << "Player ID " << playerId << " not found in available players.\n";
-            return false;
-        }
-        
-        if (team->getRosterSize() >= rosterSize) {
-            std::cout << "Team roster is full (" << rosterSize << " players maximum).\n";
-            return false;
+    JsonWriter& beginObject() { open('{'); return *this; }
+    JsonWriter& endObject() { close('}'); return *this; }
+    JsonWriter& beginArray() { open('['); return *this; }
+    JsonWriter& endArray() { close(']'); return *this; }
+    
+    JsonWriter& key(std::string_view name) {
+        separator();
+        appendString(out, name);
+        out += ':';
+        afterKey = true;
+        return *this;
+    }
+    
+    JsonWriter& value(std::string_view text) {
+        separator();
+        appendString(out, text);
+        return *this;
+    }
+    
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    
+    JsonWriter& value(bool flag) {
+        separator();
+        out += flag ? "true" : "false";
+        return *this;
+    }
+    
+    JsonWriter& value(long long number) {
+        separator();
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+        out.append(buffer, result.ptr);
+        return *this;
+    }
+    
+    JsonWriter& value(int number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(size_t number) { return value(static_cast<long long>(number)); }
+    
+    // Doubles are written with a fixed number of decimals
+    JsonWriter& value(double number, int precision = 2) {
+        separator();
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), number, std::chars_format::fixed, precision);
+        out.append(buffer, result.ptr);
+        return *this;
+    }
+    
+    // Shorthand for key(name).value(v)
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        key(name);
+        return value(v);
+    }
+};
+
+// Report rendering. Display code describes tables through this interface and a backend
+// formats them into a reusable buffer, which is written out in a single call by flush().
+class ReportWriter {
+public:
+    struct Column {
+        const char* name;
+        int width;
+        bool alignRight;
+    };
+    
+    virtual ~ReportWriter() = default;
+    
+    virtual void beginReport(std::string_view title) = 0;
+    virtual void endReport() = 0;
+    // Free-form line of text, e.g. "No teams registered yet."
+    virtual void note(std::string_view text) = 0;
+    virtual void beginTable(std::string_view title, std::initializer_list<Column> columns) = 0;
+    virtual void endTable() = 0;
+    virtual void cell(std::string_view text) = 0;
+    virtual void cell(long long number) = 0;
+    virtual void cell(double number, int precision) = 0;
+    virtual void endRow() = 0;
+    
+    void cell(const char* text) { cell(std::string_view(text)); }
+    void cell(const std::string& text) { cell(std::string_view(text)); }
+    void cell(int number) { cell(static_cast<long long>(number)); }
+    void cell(size_t number) { cell(static_cast<long long>(number)); }
+    void cell(double number) { cell(number, 1); }
+    
+    const std::string& getBuffer() const { return out; }
+    
+    // Write everything rendered so far and reset the buffer, keeping its capacity
+    void flush(std::ostream& stream) {
+        stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+        stream.flush();
+        out.clear();
+    }
+    
+    // Backend by name: "text", "csv" or "json"; nullptr if unknown
+    static std::unique_ptr<ReportWriter> create(std::string_view format);
+
+protected:
+    std::string out;
+    
+    static void appendInt(std::string& buffer, long long number) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        buffer.append(digits, result.ptr);
+    }
+    
+    static void appendFixed(std::string& buffer, double number, int precision) {
+        char digits[64];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+        buffer.append(digits, result.ptr);
+    }
+};
+
+// Fixed-width console tables, matching the layout of the interactive menus
+class TextReportWriter : public ReportWriter {
+private:
+    std::vector<Column> columns;
+    size_t column = 0;
+    int sections = 0;
+    char scratch[64];
+    
+    void pad(size_t count) {
+        out.append(count, ' ');
+    }
+    
+    void putCell(std::string_view text) {
+        if (column > 0) {
+            out += " | ";
         }
-        
-        Player* player = *it;
-        
-        // Add player to team
-        if (team->addPlayer(player)) {
-            // Remove from available players
-            availablePlayers.erase(it);
-            std::cout << player->getName() << " has been drafted to " << team->getName() << "!\n";
-            return true;
+        const Column& spec = columns[column < columns.size() ? column : columns.size() - 1];
+        size_t width = static_cast<size_t>(spec.width);
+        size_t padding = text.size() < width ? width - text.size() : 0;
+        bool last = column + 1 >= columns.size();
+        if (spec.alignRight) {
+            pad(padding);
+            out += text;
         } else {
-            std::cout << "Player is already on the team roster.\n";
-            return false;
+            out += text;
+            if (!last) {
+                pad(padding);
+            }
         }
+        column++;
+    }
+
+public:
+    // Shared writer for the interactive menus, so the buffer is allocated once
+    static TextReportWriter& console() {
+        static thread_local TextReportWriter writer;
+        return writer;
     }
     
-    // Set team lineup
-    bool setTeamLineup(Team* team, const std::vector<int>& playerIds) {
-        if (playerIds.size() != lineupSize) {
-            std::cout << "Lineup must have exactly " << lineupSize << " players.\n";
-            return false;
+    void beginReport(std::string_view title) override {
+        const size_t width = 60;
+        sections = 0;
+        out.append(width, '*');
+        out += '\n';
+        pad(title.size() < width ? (width - title.size()) / 2 : 0);
+        out += title;
+        out += '\n';
+        out.append(width, '*');
+        out += '\n';
+    }
+    
+    void endReport() override {}
+    
+    void note(std::string_view text) override {
+        out += text;
+        out += '\n';
+    }
+    
+    void beginTable(std::string_view title, std::initializer_list<Column> specs) override {
+        if (!title.empty()) {
+            out += sections > 0 ? "\n==== " : "==== ";
+            out += title;
+            out += " ====\n";
         }
-        
-        if (team->setLineup(playerIds)) {
-            std::cout << "Lineup for " << team->getName() << " has been set.\n";
-            return true;
-        } else {
-            std::cout << "Failed to set lineup. Please check player IDs.\n";
-            return false;
+        sections++;
+        columns.assign(specs.begin(), specs.end());
+        column = 0;
+        size_t ruleWidth = 0;
+        for (const Column& spec : columns) {
+            putCell(spec.name);
+            ruleWidth += spec.width + 3;
         }
+        out += '\n';
+        out.append(ruleWidth - 3, '-');
+        out += '\n';
+        column = 0;
     }
     
-    // Generate matchups for the current week
-    void generateMatchups() {
-        // Clear previous matchups
-        for (auto& matchup : schedule) {
-            delete matchup;
+    void endTable() override {}
+    
+    void cell(std::string_view text) override {
+        putCell(text);
+    }
+    
+    void cell(long long number) override {
+        auto result = std::to_chars(scratch, scratch + sizeof(scratch), number);
+        putCell(std::string_view(scratch, result.ptr - scratch));
+    }
+    
+    void cell(double number, int precision) override {
+        auto result = std::to_chars(scratch, scratch + sizeof(scratch), number, std::chars_format::fixed, precision);
+        putCell(std::string_view(scratch, result.ptr - scratch));
+    }
+    
+    void endRow() override {
+        out += '\n';
+        column = 0;
+    }
+    
+    using ReportWriter::cell;
+};
+
+// RFC 4180 CSV: one header row per table, tables separated by a blank line; notes are omitted
+class CsvReportWriter : public ReportWriter {
+private:
+    bool firstCell = true;
+    int tables = 0;
+    
+    void separator() {
+        if (!firstCell) {
+            out += ',';
         }
-        schedule.clear();
-        
-        // We need at least 2 teams for matchups
-        if (teams.size() < 2) {
-            std::cout << "Need at least 2 teams to generate matchups.\n";
-            return;
+        firstCell = false;
+    }
+
+public:
+    void beginReport(std::string_view) override {
+        tables = 0;
+    }
+    
+    void endReport() override {}
+    void note(std::string_view) override {}
+    
+    void beginTable(std::string_view, std::initializer_list<Column> specs) override {
+        if (tables++ > 0) {
+            out += '\n';
         }
-        
-        // Create a copy of team pointers that we can shuffle
-        std::vector<Team*> shuffledTeams = teams;
-        
-        // Shuffle teams randomly
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(shuffledTeams.begin(), shuffledTeams.end(), g);
-        
-        // Create matchups
-        for (size_t i = 0; i < shuffledTeams.size(); i += 2) {
-            // If we have an odd number of teams, the last team gets a bye
-            if (i + 1 >= shuffledTeams.size()) {
-                std::cout << shuffledTeams[i]->getName() << " has a bye this week.\n";
-                continue;
-            }
-            
-            Matchup* matchup = new Matchup(shuffledTeams[i], shuffledTeams[i + 1]);
-            schedule.push_back(matchup);
-            
-            std::cout << "Matchup: " << shuffledTeams[i]->getName() 
-                     << " vs " << shuffledTeams[i + 1]->getName() << std::endl;
+        for (const Column& spec : specs) {
+            cell(spec.name);
         }
+        endRow();
     }
     
-    // Simulate all matchups for the current week
-    void simulateWeek() {
-        if (schedule.empty()) {
-            std::cout << "No matchups scheduled. Generate matchups first.\n";
+    void endTable() override {}
+    
+    void cell(std::string_view text) override {
+        separator();
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out += text;
             return;
         }
-        
-        std::cout << "\n==== SIMULATING WEEK " << currentWeek << " ====\n";
-        
-        for (auto& matchup : schedule) {
-            matchup->simulate();
-            matchup->displayResults();
+        out += '"';
+        for (char c : text) {
+            if (c == '"') {
+                out += '"';
+            }
+            out += c;
         }
-        
-        // Advance to next week
-        currentWeek++;
+        out += '"';
     }
     
-    // Display league standings
-    void displayStandings() const {
-        Utility::displayTitle("LEAGUE STANDINGS");
-        
-        if (teams.empty()) {
-            std::cout << "No teams registered yet.\n";
-            return;
+    void cell(long long number) override {
+        separator();
+        appendInt(out, number);
+    }
+    
+    void cell(double number, int precision) override {
+        separator();
+        appendFixed(out, number, precision);
+    }
+    
+    void endRow() override {
+        out += '\n';
+        firstCell = true;
+    }
+    
+    using ReportWriter::cell;
+};
+
+// One JSON document per report: {"title", "tables": [{"title", "columns", "rows"}], "notes"}
+class JsonReportWriter : public ReportWriter {
+private:
+    JsonWriter json;
+    std::vector<std::string> notes;
+    bool inRow = false;
+    
+    void beginCell() {
+        if (!inRow) {
+            json.beginArray();
+            inRow = true;
         }
-        
-        // Create a copy of teams that we can sort
-        std::vector<Team*> sortedTeams = teams;
-        
-        // Sort teams by wins (descending), then by points (descending)
-        std::sort(sortedTeams.begin(), sortedTeams.end(), [](const Team* a, const Team* b) {
-            if (a->getWins() != b->getWins()) {
-                return a->getWins() > b->getWins();
+    }
+
+public:
+    JsonReportWriter() : json(out) {}
+    
+    void beginReport(std::string_view title) override {
+        notes.clear();
+        json.beginObject().field("title", title).key("tables").beginArray();
+    }
+    
+    void endReport() override {
+        json.endArray().key("notes").beginArray();
+        for (const std::string& text : notes) {
+            json.value(text);
+        }
+        json.endArray().endObject();
+        out += '\n';
+    }
+    
+    void note(std::string_view text) override {
+        notes.emplace_back(text);
+    }
+    
+    void beginTable(std::string_view title, std::initializer_list<Column> specs) override {
+        json.beginObject().field("title", title).key("columns").beginArray();
+        for (const Column& spec : specs) {
+            json.value(spec.name);
+        }
+        json.endArray().key("rows").beginArray();
+    }
+    
+    void endTable() override {
+        json.endArray().endObject();
+    }
+    
+    void cell(std::string_view text) override {
+        beginCell();
+        json.value(text);
+    }
+    
+    void cell(long long number) override {
+        beginCell();
+        json.value(number);
+    }
+    
+    void cell(double number, int precision) override {
+        beginCell();
+        json.value(number, precision);
+    }
+    
+    void endRow() override {
+        beginCell();
+        json.endArray();
+        inRow = false;
+    }
+    
+    using ReportWriter::cell;
+};
+
+std::unique_ptr<ReportWriter> ReportWriter::create(std::string_view format) {
+    if (format == "text") {
+        return std::make_unique<TextReportWriter>();
+    }
+    if (format == "csv") {
+        return std::make_unique<CsvReportWriter>();
+    }
+    if (format == "json") {
+        return std::make_unique<JsonReportWriter>();
+    }
+    return nullptr;
+}
+
+namespace Trace {
+    namespace {
+        struct ThreadEvents {
+            uint32_t threadId;
+            std::vector<Event> events;
+        };
+        
+        std::vector<ThreadEvents> collectAll() {
+            std::vector<ThreadEvents> all;
+            BufferList& list = bufferList();
+            std::lock_guard<std::mutex> lock(list.mutex);
+            for (const auto& buffer : list.buffers) {
+                all.push_back({buffer->getThreadId(), {}});
+                buffer->collect(all.back().events);
             }
-            return a->getTotalPoints() > b->getTotalPoints();
-        });
+            return all;
+        }
+    }
+    
+    // Chrome trace-event JSON (load in chrome://tracing or Perfetto)
+    void exportChromeTrace(std::ostream& out) {
+        std::string buffer;
+        JsonWriter json(buffer);
+        json.beginObject().key("traceEvents").beginArray();
+        for (const ThreadEvents& thread : collectAll()) {
+            for (const Event& event : thread.events) {
+                json.beginObject()
+                    .field("name", event.name)
+                    .field("ph", "X")
+                    .key("ts").value(event.start / 1000.0, 3)
+                    .key("dur").value(event.duration / 1000.0, 3)
+                    .field("pid", 1)
+                    .field("tid", static_cast<int>(thread.threadId))
+                    .key("args").beginObject();
+                if (COUNTS_ALLOCATIONS) {
+                    json.field("allocations", static_cast<long long>(event.allocations));
+                }
+                json.field("rngDraws", static_cast<long long>(event.rngDraws))
+                    .endObject()
+                    .endObject();
+            }
+        }
+        json.endArray().field("displayTimeUnit", "ms").endObject();
+        buffer += '\n';
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    
+    // Per-phase totals and percentiles, plus a decade histogram of durations
+    void writeSummary(ReportWriter& report) {
+        struct Phase {
+            std::vector<uint64_t> durations;
+            uint64_t allocations = 0;
+            uint64_t rngDraws = 0;
+        };
+        std::map<std::string, Phase> phases;
+        for (const ThreadEvents& thread : collectAll()) {
+            for (const Event& event : thread.events) {
+                Phase& phase = phases[event.name];
+                phase.durations.push_back(event.duration);
+                phase.allocations += event.allocations;
+                phase.rngDraws += event.rngDraws;
+            }
+        }
         
-        std::cout << std::left << std::setw(5) << "Rank" << " | "
-                  << std::setw(20) << "Team" << " | "
-                  << std::setw(20) << "Owner" << " | "
-                  << std::setw(10) << "Record" << " | "
-                  << std::setw(10) << "Points" << std::endl;
-        std::cout << std::string(70, '-') << std::endl;
+        report.beginReport("TRACE SUMMARY");
+        if (phases.empty()) {
+            report.note("No trace events recorded.");
+            report.endReport();
+            return;
+        }
         
-        for (size_t i = 0; i < sortedTeams.size(); ++i) {
-            std::cout << std::left << std::setw(5) << (i + 1) << " | "
-                      << std::setw(20) << sortedTeams[i]->getName() << " | "
-                      << std::setw(20) << sortedTeams[i]->getOwner() << " | "
-                      << std::setw(5) << sortedTeams[i]->getWins() << "-" << std::setw(4) << sortedTeams[i]->getLosses() << " | "
-                      << std::fixed << std::setprecision(1) << std::setw(10) << sortedTeams[i]->getTotalPoints() << std::endl;
+        report.beginTable("PHASES", {{"Phase", 18, false}, {"Count", 8, true}, {"Total ms", 10, true},
+                                     {"Mean us", 9, true}, {"p50 us", 9, true}, {"p99 us", 9, true},
+                                     {"Max us", 9, true}, {"Allocs", 9, true}, {"RNG draws", 10, true}});
+        for (auto& entry : phases) {
+            std::vector<uint64_t>& durations = entry.second.durations;
+            std::sort(durations.begin(), durations.end());
+            uint64_t total = 0;
+            for (uint64_t duration : durations) {
+                total += duration;
+            }
+            auto percentile = [&durations](double p) {
+                return durations[static_cast<size_t>(p * (durations.size() - 1))] / 1000.0;
+            };
+            report.cell(entry.first);
+            report.cell(durations.size());
+            report.cell(total / 1e6, 3);
+            report.cell(total / 1000.0 / durations.size(), 2);
+            report.cell(percentile(0.5), 2);
+            report.cell(percentile(0.99), 2);
+            report.cell(durations.back() / 1000.0, 2);
+            if (COUNTS_ALLOCATIONS) {
+                report.cell(static_cast<long long>(entry.second.allocations));
+            } else {
+                report.cell("n/a");
+            }
+            report.cell(static_cast<long long>(entry.second.rngDraws));
+            report.endRow();
+        }
+        report.endTable();
+        
+        report.beginTable("LATENCY HISTOGRAM", {{"Phase", 18, false}, {"<1us", 8, true}, {"<10us", 8, true},
+                                                {"<100us", 8, true}, {"<1ms", 8, true}, {"<10ms", 8, true},
+                                                {">=10ms", 8, true}});
+        for (const auto& entry : phases) {
+            size_t buckets[6] = {};
+            for (uint64_t duration : entry.second.durations) {
+                size_t bucket = 0;
+                for (uint64_t limit = 1000; bucket < 5 && duration >= limit; limit *= 10) {
+                    bucket++;
+                }
+                buckets[bucket]++;
+            }
+            report.cell(entry.first);
+            for (size_t count : buckets) {
+                report.cell(count);
+            }
+            report.endRow();
         }
+        report.endTable();
+        report.endReport();
+    }
+}
+
+// Enum for player positions
+enum class Position {
+    QUARTERBACK,
+    RUNNING_BACK,
+    WIDE_RECEIVER,
+    TIGHT_END,
+    KICKER,
+    DEFENSE
+};
+
+// Convert Position enum to string
+std::string positionToString(Position pos) {
+    switch (pos) {
+        case Position::QUARTERBACK: return "QB";
+        case Position::RUNNING_BACK: return "RB";
+        case Position::WIDE_RECEIVER: return "WR";
+        case Position::TIGHT_END: return "TE";
+        case Position::KICKER: return "K";
+        case Position::DEFENSE: return "DEF";
+        default: return "Unknown";
+    }
+}
+
+// Number of values in the Position enum
+const int POSITION_COUNT = 6;
+
+// Stat columns tracked for every player. Each position only fills the columns it uses.
+enum Stat {
+    STAT_PASSING_YARDS,
+    STAT_PASSING_TDS,
+    STAT_INTERCEPTIONS,
+    STAT_RUSHING_YARDS,
+    STAT_RUSHING_TDS,
+    STAT_RECEIVING_YARDS,
+    STAT_RECEIVING_TDS,
+    STAT_FIELD_GOALS,
+    STAT_EXTRA_POINTS,
+    STAT_SACKS,
+    STAT_DEF_INTERCEPTIONS,
+    STAT_DEF_TDS,
+    STAT_POINTS_ALLOWED,
+    STAT_RECEPTIONS,
+    STAT_COUNT
+};
+
+// One value per stat column, for a single game or a season
+using StatLine = std::array<int, STAT_COUNT>;
+
+// One player's stats and fantasy points for a single game
+struct GameRecord {
+    StatLine stats;
+    double points;
+};
+
+// Column name for a stat, as used by the importer
+inline const char* statName(Stat stat) {
+    static const char* const names[STAT_COUNT] = {
+        "passing_yards", "passing_tds", "interceptions",
+        "rushing_yards", "rushing_tds", "receiving_yards", "receiving_tds",
+        "field_goals", "extra_points",
+        "sacks", "def_interceptions", "def_tds", "points_allowed",
+        "receptions"
+    };
+    return names[stat];
+}
+
+// League-wide stat ranges (the priors of StatModel) and fantasy scoring constants
+namespace Scoring {
+    // One stat drawn for a position, with its inclusive range
+    struct StatRule {
+        Stat stat;
+        Random::IntRange range;
+    };
+
+    // Stats drawn per position, in draw order
+    inline const std::vector<StatRule>& statRules(Position pos) {
+        static const std::vector<StatRule> rules[POSITION_COUNT] = {
+            // QB
+            {{STAT_PASSING_YARDS, {150, 400}}, {STAT_PASSING_TDS, {0, 4}}, {STAT_INTERCEPTIONS, {0, 3}},
+             {STAT_RUSHING_YARDS, {0, 50}}, {STAT_RUSHING_TDS, {0, 1}}},
+            // RB
+            {{STAT_RUSHING_YARDS, {30, 150}}, {STAT_RUSHING_TDS, {0, 2}},
+             {STAT_RECEIVING_YARDS, {0, 50}}, {STAT_RECEIVING_TDS, {0, 1}}, {STAT_RECEPTIONS, {0, 6}}},
+            // WR
+            {{STAT_RECEIVING_YARDS, {20, 150}}, {STAT_RECEIVING_TDS, {0, 2}}, {STAT_RECEPTIONS, {2, 10}}},
+            // TE
+            {{STAT_RECEIVING_YARDS, {10, 100}}, {STAT_RECEIVING_TDS, {0, 1}}, {STAT_RECEPTIONS, {1, 8}}},
+            // K
+            {{STAT_FIELD_GOALS, {0, 5}}, {STAT_EXTRA_POINTS, {1, 5}}},
+            // DEF
+            {{STAT_SACKS, {0, 5}}, {STAT_DEF_INTERCEPTIONS, {0, 3}}, {STAT_DEF_TDS, {0, 1}},
+             {STAT_POINTS_ALLOWED, {0, 35}}}
+        };
+        return rules[static_cast<int>(pos)];
     }
+
+    // Standard fantasy points per unit of each stat. Points allowed is scored through the
+    // defense ladder in ScoringRules instead.
+    const double STAT_WEIGHTS[STAT_COUNT] = {
+        0.04, 4.0, -2.0,    // passing yards, passing TDs, interceptions
+        0.1, 6.0,           // rushing yards, rushing TDs
+        0.1, 6.0,           // receiving yards, receiving TDs
+        3.0, 1.0,           // field goals, extra points
+        1.0, 2.0, 6.0,      // sacks, defensive interceptions, defensive TDs
+        0.0,                // points allowed
+        0.0                 // receptions (PPR leagues weight these)
+    };
+
+    // Mean and variance of one game's fantasy points
+    struct Projection {
+        double mean;
+        double variance;
+    };
+}
+
+// Game stat distributions for one player, drawn by inverse CDF over TABLE_SIZE quantile
+// bins: one 64-bit random number picks the bins of up to eight stats (no position draws
+// more than MAX_STATS), and a draw is a shift, a mask and a lookup per stat. Yardage (and
+// points allowed) is normal, clamped at zero: the model keeps the player's mean and
+// deviation and scales the shared standard normal quantiles. Counts such as TDs,
+// receptions and field goals are Poisson at the player's per-game rate, rounded to a
+// 1/RATE_STEPS grid and read from a table shared by every model with that rate.
+class StatModel {
+public:
+    static const int TABLE_BITS = 8;
+    static const int TABLE_SIZE = 1 << TABLE_BITS;
+    static const int MAX_STATS = 5;
+    // Poisson rates are rounded to 1/RATE_STEPS; larger rates than POISSON_LIMIT are
+    // close enough to normal (and exp(-rate) would underflow)
+    static const int RATE_STEPS = 128;
+    static const int POISSON_LIMIT = 100;
+    // Weight of the position prior, in games, when fitting a player's history
+    static constexpr double PRIOR_GAMES = 3.0;
+
+private:
+    // Quantiles of a Poisson rate, with their exact moments
+    struct CountTable {
+        std::array<int16_t, TABLE_SIZE> values;
+        double mean;
+        double variance;
+    };
     
-    // Display all player statistics
-    void displayPlayerStatistics() const {
-        Utility::displayTitle("PLAYER STATISTICS");
-        
-        // Create a vector of all players (from teams and available)
-        std::vector<Player*> allPlayers;
+    // How one stat is drawn
+    struct StatParams {
+        Stat stat;
+        const CountTable* counts;   // null for normal stats
+        double mean;                // of the normal, before clamping
+        double deviation;
+        double drawMean;            // exact moments of the draws
+        double drawVariance;
+    };
+    
+    Position position;
+    bool isPriorModel;
+    int statCount;
+    std::array<StatParams, MAX_STATS> params;   // in Scoring::statRules order
+    
+    static bool isYardage(Stat stat) {
+        return stat == STAT_PASSING_YARDS || stat == STAT_RUSHING_YARDS || stat == STAT_RECEIVING_YARDS
+            || stat == STAT_POINTS_ALLOWED;
+    }
+    
+    // Standard normal quantiles at the midpoint of each table bin
+    static const std::array<double, TABLE_SIZE>& normalQuantiles() {
+        static const std::array<double, TABLE_SIZE> quantiles = [] {
+            std::array<double, TABLE_SIZE> result;
+            for (int i = 0; i < TABLE_SIZE; ++i) {
+                double u = (i + 0.5) / TABLE_SIZE;
+                double low = -10.0, high = 10.0;
+                for (int step = 0; step < 64; ++step) {
+                    double mid = (low + high) / 2.0;
+                    (0.5 * std::erfc(-mid / std::sqrt(2.0)) < u ? low : high) = mid;
+                }
+                result[i] = (low + high) / 2.0;
+            }
+            return result;
+        }();
+        return quantiles;
+    }
+    
+    // Round to the nearest count in [0, 32767]
+    static int16_t clampValue(double value) {
+        return static_cast<int16_t>(std::min(std::max(value + 0.5, 0.0), 32767.0));
+    }
+    
+    // The table for a Poisson rate (rounded to the grid), built on first use and kept for
+    // the life of the process. The grid bounds them at POISSON_LIMIT * RATE_STEPS + 1,
+    // whatever leagues import, and a lookup takes no lock.
+    static const CountTable& countTable(double rate) {
+        static std::atomic<const CountTable*> tables[POISSON_LIMIT * RATE_STEPS + 1];
+        const long step = std::lround(rate * RATE_STEPS);
+        std::atomic<const CountTable*>& slot = tables[step];
+        const CountTable* table = slot.load(std::memory_order_acquire);
+        if (table) {
+            return *table;
+        }
         
-        // Add players from teams
-        for (const auto& team : teams) {
-            const auto& roster = team->getRoster();
-            allPlayers.insert(allPlayers.end(), roster.begin(), roster.end());
+        CountTable* built = new CountTable;
+        const double mean = step / static_cast<double>(RATE_STEPS);
+        // Walk the CDF once, filling each bin with the first count that reaches it
+        double probability = std::exp(-mean);
+        double cumulative = probability;
+        int count = 0;
+        for (int i = 0; i < TABLE_SIZE; ++i) {
+            double u = (i + 0.5) / TABLE_SIZE;
+            while (cumulative < u && probability > 0.0) {
+                count++;
+                probability *= mean / count;
+                cumulative += probability;
+            }
+            built->values[i] = static_cast<int16_t>(count);
         }
+        moments(built->values.data(), built->mean, built->variance);
         
-        // Add available players
-        allPlayers.insert(allPlayers.end(), availablePlayers.begin(), availablePlayers.end());
+        // Another thread may have built the same table meanwhile; keep whichever landed first
+        if (slot.compare_exchange_strong(table, built, std::memory_order_acq_rel)) {
+            return *built;
+        }
+        delete built;
+        return *table;
+    }
+    
+    template <typename Draws>
+    static void moments(const Draws& draws, double& mean, double& variance) {
+        double sum = 0.0, sumSquares = 0.0;
+        for (int i = 0; i < TABLE_SIZE; ++i) {
+            double value = draws[i];
+            sum += value;
+            sumSquares += value * value;
+        }
+        mean = sum / TABLE_SIZE;
+        variance = sumSquares / TABLE_SIZE - mean * mean;
+    }
+    
+    StatModel(Position position, bool isPriorModel) : position(position), isPriorModel(isPriorModel), statCount(0) {}
+    
+    // Add a stat with this per-game mean (and, for yardage, standard deviation)
+    void addStat(Stat stat, double mean, double deviation) {
+        mean = std::max(mean, 0.0);
+        if (!isYardage(stat) && mean > POISSON_LIMIT) {
+            deviation = std::sqrt(mean);
+        }
         
-        // Sort players by fantasy points (descending)
-        std::sort(allPlayers.begin(), allPlayers.end(), [](const Player* a, const Player* b) {
-            return a->getFantasyPoints() > b->getFantasyPoints();
-        });
+        StatParams& entry = params[statCount++];
+        entry.stat = stat;
+        entry.mean = mean;
+        entry.deviation = deviation;
+        if (isYardage(stat) || mean > POISSON_LIMIT) {
+            entry.counts = nullptr;
+            const std::array<double, TABLE_SIZE>& z = normalQuantiles();
+            std::array<int16_t, TABLE_SIZE> draws;
+            for (int i = 0; i < TABLE_SIZE; ++i) {
+                draws[i] = clampValue(mean + deviation * z[i]);
+            }
+            moments(draws, entry.drawMean, entry.drawVariance);
+        } else {
+            entry.counts = &countTable(mean);
+            entry.drawMean = entry.counts->mean;
+            entry.drawVariance = entry.counts->variance;
+        }
+    }
+    
+    // Mean and variance of a stat's league-wide range
+    static void priorMoments(const Scoring::StatRule& rule, double& mean, double& variance) {
+        double values = rule.range.max() - rule.range.min() + 1.0;
+        mean = (rule.range.min() + rule.range.max()) / 2.0;
+        variance = (values * values - 1.0) / 12.0;
+    }
+
+public:
+    // Position default, matching the mean (and for yardage the spread) of the league-wide
+    // ranges in Scoring::statRules. Shared by every player without a history.
+    static const std::shared_ptr<const StatModel>& prior(Position pos) {
+        static const std::array<std::shared_ptr<const StatModel>, POSITION_COUNT> priors = [] {
+            std::array<std::shared_ptr<const StatModel>, POSITION_COUNT> result;
+            for (int p = 0; p < POSITION_COUNT; ++p) {
+                std::shared_ptr<StatModel> model(new StatModel(static_cast<Position>(p), true));
+                for (const auto& rule : Scoring::statRules(static_cast<Position>(p))) {
+                    double mean, variance;
+                    priorMoments(rule, mean, variance);
+                    model->addStat(rule.stat, mean, std::sqrt(variance));
+                }
+                result[p] = model;
+            }
+            return result;
+        }();
+        return priors[static_cast<int>(pos)];
+    }
+    
+    // Fit to `games` games summing to `totals`: per-game rates shrunk toward the prior by
+    // PRIOR_GAMES games. Season totals carry no spread, so yardage keeps the prior's
+    // coefficient of variation; a Poisson count's variance is its rate.
+    static std::shared_ptr<const StatModel> fit(Position pos, int games, const StatLine& totals) {
+        if (games <= 0) {
+            return prior(pos);
+        }
+        std::shared_ptr<StatModel> model(new StatModel(pos, false));
+        for (const auto& rule : Scoring::statRules(pos)) {
+            double priorMean, priorVariance;
+            priorMoments(rule, priorMean, priorVariance);
+            double mean = (priorMean * PRIOR_GAMES + totals[rule.stat]) / (PRIOR_GAMES + games);
+            double deviation = std::sqrt(priorVariance) * (priorMean > 0.0 ? mean / priorMean : 1.0);
+            model->addStat(rule.stat, mean, deviation);
+        }
+        return model;
+    }
+    
+    // A stat's value in one quantile bin
+    int draw(int index, unsigned bin) const {
+        const StatParams& entry = params[index];
+        return entry.counts ? entry.counts->values[bin]
+                            : clampValue(entry.mean + entry.deviation * normalQuantiles()[bin]);
+    }
+    
+    // Draw one game's stats
+    StatLine sample(Random::Engine& gen) const {
+        StatLine line{};
+        uint64_t bits = gen();
+        for (int s = 0; s < statCount; ++s) {
+            line[params[s].stat] = draw(s, bits & (TABLE_SIZE - 1));
+            bits >>= TABLE_BITS;
+        }
+        return line;
+    }
+    
+    Position getPosition() const { return position; }
+    bool isPrior() const { return isPriorModel; }
+    int getStatCount() const { return statCount; }
+    Stat getStat(int index) const { return params[index].stat; }
+    double getMean(int index) const { return params[index].drawMean; }
+    double getVariance(int index) const { return params[index].drawVariance; }
+};
+
+// Vectorized column kernels (AVX2 when the build targets it, scalar otherwise)
+namespace Kernels {
+    // out[i] += weight * column[i]
+    inline void accumulateWeighted(double* out, const int* column, double weight, size_t count) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d w = _mm256_set1_pd(weight);
+        for (; i + 4 <= count; i += 4) {
+            __m256d values = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i)));
+            __m256d sum = _mm256_add_pd(_mm256_loadu_pd(out + i), _mm256_mul_pd(values, w));
+            _mm256_storeu_pd(out + i, sum);
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] += weight * column[i];
+        }
+    }
+
+    // out[i] += table[column[i]], with column values clamped to [0, tableSize)
+    inline void accumulateLookup(double* out, const int* column, const double* table, int tableSize, size_t count) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m128i low = _mm_setzero_si128();
+        const __m128i high = _mm_set1_epi32(tableSize - 1);
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (; i + 4 <= count; i += 4) {
+            __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+            index = _mm_min_epi32(_mm_max_epi32(index, low), high);
+            // The masked form with every lane enabled, so no lane is left uninitialized
+            __m256d bonus = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, index, all, 8);
+            __m256d sum = _mm256_add_pd(_mm256_loadu_pd(out + i), bonus);
+            _mm256_storeu_pd(out + i, sum);
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] += table[std::min(std::max(column[i], 0), tableSize - 1)];
+        }
+    }
+}
+
+// League scoring settings: a weight per stat (optionally overridden for one position) and
+// a ladder of defense bonuses by points allowed. Every change recompiles flat tables, so
+// scoring a stat line is a dot product with its position's weight row plus one lookup,
+// with no branches on position or stat.
+class ScoringRules {
+public:
+    // Bonus for holding an opponent to at most maxAllowed points
+    struct Tier {
+        int maxAllowed;
+        double bonus;
+    };
+    
+    // Points allowed beyond the table share its last entry
+    static const int ALLOWED_TABLE_SIZE = 128;
+
+private:
+    std::string name;
+    std::array<double, STAT_COUNT> weights;
+    std::array<std::array<double, STAT_COUNT>, POSITION_COUNT> overrides;   // NaN where unset
+    std::vector<Tier> tiers;        // ascending maxAllowed
+    double worstBonus;              // for anything above the last tier
+    
+    // Compiled form
+    std::array<std::array<double, STAT_COUNT>, POSITION_COUNT> rowWeights;
+    std::array<double, POSITION_COUNT> bonusScale;  // 1 for defense, 0 otherwise
+    std::array<double, ALLOWED_TABLE_SIZE> allowedBonus;
+    std::array<Scoring::Projection, POSITION_COUNT> projections;
+    
+    void compile() {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                rowWeights[p][s] = std::isnan(overrides[p][s]) ? weights[s] : overrides[p][s];
+            }
+            // Points allowed only counts through the ladder
+            rowWeights[p][STAT_POINTS_ALLOWED] = 0.0;
+            bonusScale[p] = static_cast<Position>(p) == Position::DEFENSE ? 1.0 : 0.0;
+        }
         
-        // Display table header
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(5) << "Pos" << " | "
-                  << std::setw(15) << "Team" << " | "
-                  << std::setw(8) << "Points" << std::endl;
-        std::cout << std::string(60, '-') << std::endl;
+        size_t tier = 0;
+        for (int allowed = 0; allowed < ALLOWED_TABLE_SIZE; ++allowed) {
+            while (tier < tiers.size() && allowed > tiers[tier].maxAllowed) {
+                tier++;
+            }
+            allowedBonus[allowed] = tier < tiers.size() ? tiers[tier].bonus : worstBonus;
+        }
         
-        // Display players
-        for (const auto& player : allPlayers) {
-            if (player->getFantasyPoints() > 0) { // Only show players with points
-                player->displayInfo();
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            projections[p] = moments(*StatModel::prior(static_cast<Position>(p)));
+        }
+    }
+    
+    // A model's stats are drawn independently, so the moments of its points add up stat by
+    // stat; the defense ladder is averaged over the points-allowed table
+    Scoring::Projection moments(const StatModel& model) const {
+        const int p = static_cast<int>(model.getPosition());
+        Scoring::Projection projection{0.0, 0.0};
+        for (int s = 0; s < model.getStatCount(); ++s) {
+            double weight = rowWeights[p][model.getStat(s)];
+            projection.mean += weight * model.getMean(s);
+            projection.variance += weight * weight * model.getVariance(s);
+            
+            if (model.getStat(s) == STAT_POINTS_ALLOWED && bonusScale[p] != 0.0) {
+                double sum = 0.0, sumSquares = 0.0;
+                for (int i = 0; i < StatModel::TABLE_SIZE; ++i) {
+                    double bonus = pointsAllowedBonus(model.draw(s, i));
+                    sum += bonus;
+                    sumSquares += bonus * bonus;
+                }
+                double bonusMean = sum / StatModel::TABLE_SIZE;
+                projection.mean += bonusMean;
+                projection.variance += sumSquares / StatModel::TABLE_SIZE - bonusMean * bonusMean;
             }
         }
+        return projection;
+    }
+
+public:
+    // Standard (non-PPR) scoring
+    ScoringRules() : name("standard"), worstBonus(-4.0) {
+        std::copy(std::begin(Scoring::STAT_WEIGHTS), std::end(Scoring::STAT_WEIGHTS), weights.begin());
+        for (auto& row : overrides) {
+            row.fill(std::numeric_limits<double>::quiet_NaN());
+        }
+        tiers = {{0, 10.0}, {6, 7.0}, {13, 4.0}, {20, 1.0}, {27, 0.0}, {34, -1.0}};
+        compile();
     }
     
-    // Display weekly report
-    void weeklyReport() const {
-        Utility::displayTitle("WEEK " + std::to_string(currentWeek - 1) + " REPORT");
-        
-        if (schedule.empty()) {
-            std::cout << "No matchups have been simulated yet.\n";
+    // Shared standard rules, used wherever no league rules are given
+    static const ScoringRules& standard() {
+        static const ScoringRules rules;
+        return rules;
+    }
+    
+    // Built-in rule sets: "standard", "half-ppr" and "ppr". Returns false for other names.
+    static bool preset(const std::string& presetName, ScoringRules& rules) {
+        rules = ScoringRules();
+        if (presetName == "half-ppr") {
+            rules.setWeight(STAT_RECEPTIONS, 0.5);
+        } else if (presetName == "ppr") {
+            rules.setWeight(STAT_RECEPTIONS, 1.0);
+        } else if (presetName != "standard") {
+            return false;
+        }
+        rules.name = presetName;
+        return true;
+    }
+    
+    const std::string& getName() const { return name; }
+    void setName(const std::string& value) { name = value; }
+    
+    double getWeight(Stat stat, Position pos) const { return rowWeights[static_cast<int>(pos)][stat]; }
+    
+    // The rules as set, before compiling (overrides are NaN where unset)
+    double getBaseWeight(Stat stat) const { return weights[stat]; }
+    double getOverride(Stat stat, Position pos) const { return overrides[static_cast<int>(pos)][stat]; }
+    const std::vector<Tier>& getTiers() const { return tiers; }
+    double getWorstBonus() const { return worstBonus; }
+    
+    // Points per unit of a stat for every position without an override of its own
+    void setWeight(Stat stat, double weight) {
+        weights[stat] = weight;
+        compile();
+    }
+    
+    // Points per unit of a stat for one position (e.g. a tight end reception premium)
+    void setWeight(Stat stat, Position pos, double weight) {
+        overrides[static_cast<int>(pos)][stat] = weight;
+        compile();
+    }
+    
+    // Replace the defense ladder; tiers must be in ascending maxAllowed order
+    void setPointsAllowedTiers(const std::vector<Tier>& ladder, double beyondLastTier) {
+        tiers = ladder;
+        worstBonus = beyondLastTier;
+        compile();
+    }
+    
+    double pointsAllowedBonus(int pointsAllowed) const {
+        return allowedBonus[std::min(std::max(pointsAllowed, 0), ALLOWED_TABLE_SIZE - 1)];
+    }
+    
+    // Fantasy points for one game's stats
+    double score(const StatLine& line, Position pos) const {
+        const std::array<double, STAT_COUNT>& row = rowWeights[static_cast<int>(pos)];
+        double points = 0.0;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            points += row[s] * line[s];
+        }
+        return points + bonusScale[static_cast<int>(pos)] * pointsAllowedBonus(line[STAT_POINTS_ALLOWED]);
+    }
+    
+    // Points for totals summed over several games. The defense ladder is per game, so it
+    // cannot be applied to totals and is left out.
+    double scoreTotals(const StatLine& totals, Position pos) const {
+        const std::array<double, STAT_COUNT>& row = rowWeights[static_cast<int>(pos)];
+        double points = 0.0;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            points += row[s] * totals[s];
+        }
+        return points;
+    }
+    
+    // points[i] = score of row i, for count rows of one position stored column by column
+    void scoreColumns(Position pos, const std::vector<int>* columns, double* points, size_t count) const {
+        const std::array<double, STAT_COUNT>& row = rowWeights[static_cast<int>(pos)];
+        std::fill(points, points + count, 0.0);
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            if (row[s] != 0.0) {
+                Kernels::accumulateWeighted(points, columns[s].data(), row[s], count);
+            }
+        }
+        if (bonusScale[static_cast<int>(pos)] != 0.0) {
+            Kernels::accumulateLookup(points, columns[STAT_POINTS_ALLOWED].data(), allowedBonus.data(),
+                                      ALLOWED_TABLE_SIZE, count);
+        }
+    }
+    
+    // Exact mean and variance of one simulated game's points for a position's prior
+    Scoring::Projection projection(Position pos) const {
+        return projections[static_cast<int>(pos)];
+    }
+    
+    // Same for any stat model; priors come from the compiled table
+    Scoring::Projection projection(const StatModel& model) const {
+        return model.isPrior() ? projections[static_cast<int>(model.getPosition())] : moments(model);
+    }
+};
+
+// Columnar (structure-of-arrays) store of game stats, grouped by position.
+// Rows are tagged by the caller (a player slot, a team index, ...) so the same table can
+// score a league's lineups or a Monte Carlo batch without touching Player objects.
+class PlayerStatsTable {
+public:
+    struct Group {
+        std::vector<uint32_t> tags;
+        std::vector<const StatModel*> models;      // what each row's games are drawn from
+        std::vector<uint64_t> draws;               // random word behind each row's next game
+        std::vector<int> columns[STAT_COUNT];      // may hold spare rows past size(), kept for reuse
+        std::vector<double> points;
+        
+        size_t size() const { return tags.size(); }
+    };
+
+private:
+    Group groups[POSITION_COUNT];
+    
+    // Zero the columns of rows added since the last fill. The columns are not shrunk by
+    // clear, so a reused table only grows them past its largest batch.
+    static void fillColumns(Group& group) {
+        size_t from = group.points.size();
+        size_t to = group.size();
+        if (from == to) {
             return;
         }
-        
-        // Show matchup results
-        std::cout << "==== MATCHUP RESULTS ====\n";
-        for (const auto& matchup : schedule) {
-            if (matchup->getIsCompleted()) {
-                std::cout << matchup->getHomeTeam()->getName() << " vs " << matchup->getAwayTeam()->getName();
-                std::cout << ": " << std::fixed << std::setprecision(1) 
-                          << matchup->getHomeScore() << " - " << matchup->getAwayScore() << std::endl;
+        for (auto& column : group.columns) {
+            if (column.size() < to) {
+                column.resize(to);
             }
+            std::fill(column.begin() + from, column.begin() + to, 0);
         }
-        
-        // Show team standings
-        displayStandings();
-        
-        // Show top 5 players of the week
-        std::cout << "\n==== TOP PERFORMERS ====\n";
-        
-        // Create a vector of all players from teams
-        std::vector<Player*> allPlayers;
-        for (const auto& team : teams) {
-            const auto& roster = team->getRoster();
-            allPlayers.insert(allPlayers.end(), roster.begin(), roster.end());
+        group.points.resize(to, 0.0);
+    }
+
+public:
+    // Remove all rows but keep the allocated column storage for reuse
+    void clear() {
+        for (auto& group : groups) {
+            group.tags.clear();
+            group.models.clear();
+            group.draws.clear();
+            group.points.clear();
         }
-        
-        // Sort players by fantasy points (descending)
-        std::sort(allPlayers.begin(), allPlayers.end(), [](const Player* a, const Player* b) {
-            return a->getFantasyPoints() > b->getFantasyPoints();
+    }
+    
+    // Add a row for a position; returns its index within the position group. Rows are
+    // simulated from the position prior unless a model (which must outlive the table) is given.
+    size_t add(Position pos, uint32_t tag, const StatLine& line = StatLine{}, const StatModel* model = nullptr) {
+        Group& group = groups[static_cast<int>(pos)];
+        group.tags.push_back(tag);
+        group.models.push_back(model ? model : StatModel::prior(pos).get());
+        group.draws.push_back(0);
+        fillColumns(group);
+        size_t row = group.size() - 1;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            group.columns[s][row] = line[s];
+        }
+        return row;
+    }
+    
+    // Add a row to be simulated from a model with the given random word (see simulateDrawn).
+    // Only the row's key is written; its stat columns are filled once per pass.
+    size_t addDrawn(Position pos, uint32_t tag, const StatModel* model, uint64_t draw) {
+        Group& group = groups[static_cast<int>(pos)];
+        group.tags.push_back(tag);
+        group.models.push_back(model);
+        group.draws.push_back(draw);
+        return group.tags.size() - 1;
+    }
+    
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& group : groups) {
+            total += group.size();
+        }
+        return total;
+    }
+    
+    const Group& group(Position pos) const { return groups[static_cast<int>(pos)]; }
+    
+    // Draw one game for every row, taking the random words from the engine group by group
+    void simulate(Random::Engine& gen) {
+        for (auto& group : groups) {
+            for (uint64_t& draw : group.draws) {
+                draw = gen();
+            }
+        }
+        simulateDrawn();
+    }
+    
+    // Draw one game for every row from the words given to addDrawn or by simulate. Every model
+    // of a position draws the same stats, so the columns are resolved once per group and
+    // each row is one draw per stat.
+    void simulateDrawn() {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            Group& group = groups[p];
+            if (group.size() == 0) {
+                continue;
+            }
+            fillColumns(group);
+            const StatModel& prior = *StatModel::prior(static_cast<Position>(p));
+            const int statCount = prior.getStatCount();
+            int* columns[STAT_COUNT];
+            for (int s = 0; s < statCount; ++s) {
+                columns[s] = group.columns[prior.getStat(s)].data();
+            }
+            for (size_t i = 0; i < group.size(); ++i) {
+                const StatModel& model = *group.models[i];
+                uint64_t bits = group.draws[i];
+                for (int s = 0; s < statCount; ++s) {
+                    columns[s][i] = model.draw(s, bits & (StatModel::TABLE_SIZE - 1));
+                    bits >>= StatModel::TABLE_BITS;
+                }
+            }
+        }
+    }
+    
+    // Compute fantasy points for every row from its stat columns
+    void score(const ScoringRules& rules = ScoringRules::standard()) {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            Group& group = groups[p];
+            if (group.size() == 0) {
+                continue;
+            }
+            fillColumns(group);
+            rules.scoreColumns(static_cast<Position>(p), group.columns, group.points.data(), group.size());
+        }
+    }
+    
+    // Gather one row back into a stat line
+    StatLine row(Position pos, size_t index) const {
+        const Group& group = groups[static_cast<int>(pos)];
+        StatLine line{};
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            line[s] = group.columns[s][index];
+        }
+        return line;
+    }
+    
+    // Add each row's points to totals[tag]
+    void scatterPoints(double* totals) const {
+        for (const auto& group : groups) {
+            for (size_t i = 0; i < group.size(); ++i) {
+                totals[group.tags[i]] += group.points[i];
+            }
+        }
+    }
+};
+
+// Player class to store player information and statistics
+class Player {
+private:
+    int id;
+    std::string name;
+    Position position;
+    const std::string* team;    // interned by the league
+    
+    // Player statistics
+    int gamesPlayed;
+    StatLine stats;
+    
+    // Fantasy points
+    double fantasyPoints;
+    
+    // Imported history the stat model was fit from
+    int historyGames;
+    StatLine historyStats;
+    std::shared_ptr<const StatModel> model;
+
+public:
+    Player(int id, const std::string& name, Position position, const std::string* team)
+        : id(id), name(name), position(position), team(team),
+          gamesPlayed(0), stats{}, fantasyPoints(0.0), historyGames(0), historyStats{},
+          model(StatModel::prior(position)) {}
+    
+    // Getters
+    int getId() const { return id; }
+    std::string getName() const { return name; }
+    Position getPosition() const { return position; }
+    const std::string& getTeam() const { return *team; }
+    double getFantasyPoints() const { return fantasyPoints; }
+    int getGamesPlayed() const { return gamesPlayed; }
+    const StatLine& getStats() const { return stats; }
+    const StatModel& getModel() const { return *model; }
+    const std::shared_ptr<const StatModel>& shareModel() const { return model; }
+    int getHistoryGames() const { return historyGames; }
+    const StatLine& getHistoryStats() const { return historyStats; }
+    
+    // Draw future games from a model fit to `games` games of history totalling `totals`
+    void fitModel(int games, const StatLine& totals) {
+        historyGames = games;
+        historyStats = totals;
+        model = StatModel::fit(position, games, totals);
+    }
+    
+    // Restore season totals loaded from a snapshot
+    void restoreStats(int games, const StatLine& totals, double points) {
+        gamesPlayed = games;
+        stats = totals;
+        fantasyPoints = points;
+    }
+    
+    // Add one game's stats and points to the season totals
+    void recordGame(const StatLine& game, double gamePoints) {
+        gamesPlayed++;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            stats[s] += game[s];
+        }
+        fantasyPoints += gamePoints;
+    }
+    
+    // Simulate a game from the player's stat model; adds it to the season totals and
+    // returns that game alone
+    GameRecord simulateGamePerformance(const ScoringRules& rules = ScoringRules::standard(),
+                                       Random::Engine& gen = Random::engine()) {
+        GameRecord game;
+        game.stats = model->sample(gen);
+        game.points = rules.score(game.stats, position);
+        recordGame(game.stats, game.points);
+        return game;
+    }
+    
+    // Start a table with the columns written by writeRow
+    static void beginTable(ReportWriter& report, std::string_view title = {}) {
+        report.beginTable(title, {{"ID", 4, false}, {"Name", 20, false}, {"Pos", 5, false},
+                                  {"Team", 15, false}, {"Points", 8, false}});
+    }
+    
+    // Write player information as a table row
+    void writeRow(ReportWriter& report) const {
+        writeRow(report, fantasyPoints);
+    }
+    
+    // Same, with the points for some other period in the Points column
+    void writeRow(ReportWriter& report, double points) const {
+        report.cell(id);
+        report.cell(name);
+        report.cell(positionToString(position));
+        report.cell(*team);
+        report.cell(points);
+        report.endRow();
+    }
+    
+    // Display detailed player statistics
+    void displayDetailedStats() const {
+        std::cout << "\n===== " << name << " (" << positionToString(position) << ", " << *team << ") =====\n";
+        std::cout << "Games Played: " << gamesPlayed << '\n';
+        std::cout << "Fantasy Points: " << std::fixed << std::setprecision(1) << fantasyPoints << '\n';
+        
+        switch (position) {
+            case Position::QUARTERBACK:
+                std::cout << "Passing Yards: " << stats[STAT_PASSING_YARDS] << '\n';
+                std::cout << "Passing TDs: " << stats[STAT_PASSING_TDS] << '\n';
+                std::cout << "Interceptions: " << stats[STAT_INTERCEPTIONS] << '\n';
+                std::cout << "Rushing Yards: " << stats[STAT_RUSHING_YARDS] << '\n';
+                std::cout << "Rushing TDs: " << stats[STAT_RUSHING_TDS] << '\n';
+                break;
+            case Position::RUNNING_BACK:
+                std::cout << "Rushing Yards: " << stats[STAT_RUSHING_YARDS] << '\n';
+                std::cout << "Rushing TDs: " << stats[STAT_RUSHING_TDS] << '\n';
+                std::cout << "Receiving Yards: " << stats[STAT_RECEIVING_YARDS] << '\n';
+                std::cout << "Receiving TDs: " << stats[STAT_RECEIVING_TDS] << '\n';
+                std::cout << "Receptions: " << stats[STAT_RECEPTIONS] << '\n';
+                break;
+            case Position::WIDE_RECEIVER:
+            case Position::TIGHT_END:
+                std::cout << "Receiving Yards: " << stats[STAT_RECEIVING_YARDS] << '\n';
+                std::cout << "Receiving TDs: " << stats[STAT_RECEIVING_TDS] << '\n';
+                std::cout << "Receptions: " << stats[STAT_RECEPTIONS] << '\n';
+                break;
+            case Position::KICKER:
+                std::cout << "Field Goals: " << stats[STAT_FIELD_GOALS] << '\n';
+                std::cout << "Extra Points: " << stats[STAT_EXTRA_POINTS] << '\n';
+                break;
+            case Position::DEFENSE:
+                std::cout << "Sacks: " << stats[STAT_SACKS] << '\n';
+                std::cout << "Interceptions: " << stats[STAT_DEF_INTERCEPTIONS] << '\n';
+                std::cout << "Defensive TDs: " << stats[STAT_DEF_TDS] << '\n';
+                break;
+        }
+    }
+};
+
+// Keeps the k best items seen so far in a bounded heap: O(n log k) instead of a full sort
+template <typename T, typename Better>
+class TopK {
+private:
+    size_t limit;
+    Better better;
+    std::vector<T> heap;    // worst kept item on top
+
+public:
+    // The limit is often a caller's "all of them", so the heap grows with what is pushed
+    // rather than reserving it
+    TopK(size_t limit, Better better) : limit(limit), better(better) {}
+    
+    void push(const T& item) {
+        if (limit == 0) {
+            return;
+        }
+        if (heap.size() < limit) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(item, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = item;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+    
+    // Kept items, best first
+    std::vector<T> sorted() const {
+        std::vector<T> result = heap;
+        std::sort_heap(result.begin(), result.end(), better);
+        return result;
+    }
+};
+
+template <typename T, typename Better>
+TopK<T, Better> makeTopK(size_t limit, Better better) {
+    return TopK<T, Better>(limit, better);
+}
+
+// Week-by-week stat log for every player in a league. Each week appends one columnar
+// block: a dense column of running point totals (so a week-range sum is one subtraction
+// per player) and the stat lines of the players who played that week, stored as
+// varint-encoded deltas against their previous totals.
+class StatHistory {
+public:
+    struct Leader {
+        const Player* player;
+        double points;
+    };
+
+private:
+    struct Week {
+        std::vector<double> pointsThrough;  // points from firstWeek through this week, by slot
+        std::vector<uint32_t> slots;        // players with a game this week, ascending
+        std::vector<uint32_t> offsets;      // start of each player's row in bytes, plus an end marker
+        std::vector<uint8_t> bytes;         // games, then each stat, as zigzag varints
+    };
+    
+    std::vector<const Player*> players;     // by slot, in the order they were tracked
+    IdMap<uint32_t> slotOf;
+    // Totals already accounted for, to diff against at the next capture
+    std::vector<int> baseGames;
+    std::vector<StatLine> baseStats;
+    std::vector<double> basePoints;
+    
+    std::vector<Week> weeks;
+    int firstWeek;
+    
+    static void putVarint(std::vector<uint8_t>& out, int64_t value) {
+        uint64_t bits = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        while (bits >= 0x80) {
+            out.push_back(static_cast<uint8_t>(bits | 0x80));
+            bits >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(bits));
+    }
+    
+    static int64_t getVarint(const uint8_t*& in) {
+        uint64_t bits = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *in++;
+            bits |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        return static_cast<int64_t>(bits >> 1) ^ -static_cast<int64_t>(bits & 1);
+    }
+    
+    // Index into weeks holding the totals through a week; -1 if it is before the log
+    long weekIndex(int week) const {
+        return std::min<long>(static_cast<long>(week) - firstWeek, static_cast<long>(weeks.size()) - 1);
+    }
+    
+    double pointsThrough(uint32_t slot, long index) const {
+        if (index < 0) {
+            return 0.0;
+        }
+        const std::vector<double>& column = weeks[index].pointsThrough;
+        return slot < column.size() ? column[slot] : 0.0;
+    }
+
+public:
+    StatHistory() : firstWeek(1) {}
+    
+    // Start following a player; games already played are not part of the log
+    void track(const Player* player) {
+        uint32_t slot = static_cast<uint32_t>(players.size());
+        if (!slotOf.insert(player->getId(), slot)) {
+            return;
+        }
+        players.push_back(player);
+        baseGames.push_back(player->getGamesPlayed());
+        baseStats.push_back(player->getStats());
+        basePoints.push_back(player->getFantasyPoints());
+    }
+    
+    // Append everything played since the last capture as the given week. Weeks must not go
+    // backwards; a skipped week is logged as empty and a repeated one extends the last block.
+    void capture(int week) {
+        if (weeks.empty()) {
+            firstWeek = week;
+        }
+        while (static_cast<long>(weeks.size()) <= static_cast<long>(week) - firstWeek) {
+            Week next;
+            if (!weeks.empty()) {
+                next.pointsThrough = weeks.back().pointsThrough;
+            }
+            next.offsets.push_back(0);
+            weeks.push_back(std::move(next));
+        }
+        
+        Week& current = weeks.back();
+        std::vector<double>& points = current.pointsThrough;
+        points.resize(players.size(), 0.0);
+        for (uint32_t slot = 0; slot < players.size(); ++slot) {
+            const Player* player = players[slot];
+            int games = player->getGamesPlayed() - baseGames[slot];
+            if (games == 0) {
+                continue;
+            }
+            
+            const StatLine& stats = player->getStats();
+            current.slots.push_back(slot);
+            putVarint(current.bytes, games);
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                putVarint(current.bytes, static_cast<int64_t>(stats[s]) - baseStats[slot][s]);
+            }
+            current.offsets.push_back(static_cast<uint32_t>(current.bytes.size()));
+            points[slot] += player->getFantasyPoints() - basePoints[slot];
+            
+            baseGames[slot] = player->getGamesPlayed();
+            baseStats[slot] = stats;
+            basePoints[slot] = player->getFantasyPoints();
+        }
+    }
+    
+    bool empty() const { return weeks.empty(); }
+    int getFirstWeek() const { return firstWeek; }
+    int getLastWeek() const { return firstWeek + static_cast<int>(weeks.size()) - 1; }
+    
+    // Fantasy points a player scored in weeks [fromWeek, toWeek], in O(1)
+    double points(int playerId, int fromWeek, int toWeek) const {
+        const uint32_t* slot = slotOf.find(playerId);
+        if (!slot || weeks.empty() || fromWeek > toWeek) {
+            return 0.0;
+        }
+        return pointsThrough(*slot, weekIndex(toWeek)) - pointsThrough(*slot, weekIndex(fromWeek - 1));
+    }
+    
+    // Stat totals a player accumulated in weeks [fromWeek, toWeek]; games receives the game count
+    StatLine stats(int playerId, int fromWeek, int toWeek, int* games = nullptr) const {
+        StatLine total{};
+        int gameCount = 0;
+        const uint32_t* slot = slotOf.find(playerId);
+        if (slot && !weeks.empty()) {
+            long last = weekIndex(toWeek);
+            for (long w = std::max(0L, weekIndex(fromWeek - 1) + 1); w <= last; ++w) {
+                const Week& week = weeks[w];
+                auto it = std::lower_bound(week.slots.begin(), week.slots.end(), *slot);
+                if (it == week.slots.end() || *it != *slot) {
+                    continue;
+                }
+                const uint8_t* in = week.bytes.data() + week.offsets[it - week.slots.begin()];
+                gameCount += static_cast<int>(getVarint(in));
+                for (int s = 0; s < STAT_COUNT; ++s) {
+                    total[s] += static_cast<int>(getVarint(in));
+                }
+            }
+        }
+        if (games) {
+            *games = gameCount;
+        }
+        return total;
+    }
+    
+    // The k players with the most points in weeks [fromWeek, toWeek] among those accepted
+    // by filter(const Player*), best first; players without points are left out
+    template <typename Filter>
+    std::vector<Leader> top(size_t k, int fromWeek, int toWeek, Filter filter) const {
+        auto best = makeTopK<Leader>(k, [](const Leader& a, const Leader& b) {
+            return a.points > b.points;
         });
+        if (weeks.empty() || fromWeek > toWeek || weekIndex(toWeek) < 0) {
+            return best.sorted();
+        }
         
-        // Display table header
-        std::cout << std::left << std::setw(4) << "ID" << " | "
-                  << std::setw(20) << "Name" << " | "
-                  << std::setw(5) << "Pos" << " | "
-                  << std::setw(15) << "Team" << " | "
-                  << std::setw(8) << "Points" << std::endl;
-        std::cout << std::string(60, '-') << std::endl;
+        // Both columns are contiguous, so the scan is two sequential reads per player
+        static const std::vector<double> none;
+        long before = weekIndex(fromWeek - 1);
+        const std::vector<double>& end = weeks[weekIndex(toWeek)].pointsThrough;
+        const std::vector<double>& start = before < 0 ? none : weeks[before].pointsThrough;
+        for (size_t slot = 0; slot < end.size(); ++slot) {
+            double points = end[slot] - (slot < start.size() ? start[slot] : 0.0);
+            if (points > 0.0 && filter(players[slot])) {
+                best.push({players[slot], points});
+            }
+        }
+        return best.sorted();
+    }
+    
+    std::vector<Leader> top(size_t k, int fromWeek, int toWeek) const {
+        return top(k, fromWeek, toWeek, [](const Player*) { return true; });
+    }
+    
+    // Points every tracked player would have scored over the logged weeks under other rules,
+    // in tracking order. Each week is unpacked into a columnar table and scored in one
+    // vectorized pass. (A week with two games for a player is scored as one.)
+    std::vector<Leader> rescore(const ScoringRules& rules) const {
+        std::vector<double> totals(players.size(), 0.0);
+        PlayerStatsTable table;
+        for (const Week& week : weeks) {
+            table.clear();
+            for (size_t row = 0; row < week.slots.size(); ++row) {
+                const uint8_t* in = week.bytes.data() + week.offsets[row];
+                getVarint(in);  // games
+                StatLine line;
+                for (int s = 0; s < STAT_COUNT; ++s) {
+                    line[s] = static_cast<int>(getVarint(in));
+                }
+                table.add(players[week.slots[row]]->getPosition(), week.slots[row], line);
+            }
+            table.score(rules);
+            table.scatterPoints(totals.data());
+        }
         
-        // Display top 5 players (or fewer if there aren't that many)
-        int count = 0;
-        for (const auto& player : allPlayers) {
-            if (player->getFantasyPoints() > 0) { // Only show players with points
-                player->displayInfo();
-                count++;
-                if (count >= 5) break;
+        std::vector<Leader> result(players.size());
+        for (size_t slot = 0; slot < players.size(); ++slot) {
+            result[slot] = {players[slot], totals[slot]};
+        }
+        return result;
+    }
+};
+
+// League table ordered by wins, then total points. Teams report each result as it
+// happens and move only as far as their new record takes them, so reads never sort.
+class Standings {
+private:
+    struct Entry {
+        Team* team;
+        int wins;
+        double points;
+    };
+    
+    std::vector<Entry> entries;     // by standings ID
+    std::vector<int> order;         // standings IDs, best first
+    std::vector<size_t> rankOf;     // by standings ID
+    bool batching = false;
+    
+    bool ahead(int a, int b) const {
+        if (entries[a].wins != entries[b].wins) {
+            return entries[a].wins > entries[b].wins;
+        }
+        return entries[a].points > entries[b].points;
+    }
+    
+    void place(size_t rank, int id) {
+        order[rank] = id;
+        rankOf[id] = rank;
+    }
+
+public:
+    // Add a team and return its standings ID
+    int add(Team* team, int wins, double points) {
+        int id = static_cast<int>(entries.size());
+        entries.push_back({team, wins, points});
+        order.push_back(id);
+        rankOf.push_back(order.size() - 1);
+        update(id, wins, points);
+        return id;
+    }
+    
+    // Record a team's new totals and move it to its new rank
+    void update(int id, int wins, double points) {
+        entries[id].wins = wins;
+        entries[id].points = points;
+        if (batching) {
+            return;
+        }
+        size_t rank = rankOf[id];
+        while (rank > 0 && ahead(id, order[rank - 1])) {
+            place(rank, order[rank - 1]);
+            rank--;
+        }
+        while (rank + 1 < order.size() && ahead(order[rank + 1], id)) {
+            place(rank, order[rank + 1]);
+            rank++;
+        }
+        place(rank, id);
+    }
+    
+    // Between beginBatch() and endBatch() updates only record totals, and the order is
+    // rebuilt once with a stable sort. Used when most teams change at once (a whole week),
+    // where moving each team past every team with the same record would be quadratic.
+    void beginBatch() {
+        batching = true;
+    }
+    
+    void endBatch() {
+        batching = false;
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return ahead(a, b); });
+        for (size_t rank = 0; rank < order.size(); ++rank) {
+            rankOf[order[rank]] = rank;
+        }
+    }
+    
+    size_t size() const { return order.size(); }
+    Team* at(size_t rank) const { return entries[order[rank]].team; }
+};
+
+// A lineup slot and the positions it accepts, as a mask of (1 << Position) bits
+struct LineupSlot {
+    const char* name;
+    unsigned positions;
+    
+    bool accepts(Position pos) const {
+        return (positions & (1u << static_cast<int>(pos))) != 0;
+    }
+};
+
+namespace LineupSlots {
+    const LineupSlot QB{"QB", 1u << static_cast<int>(Position::QUARTERBACK)};
+    const LineupSlot RB{"RB", 1u << static_cast<int>(Position::RUNNING_BACK)};
+    const LineupSlot WR{"WR", 1u << static_cast<int>(Position::WIDE_RECEIVER)};
+    const LineupSlot TE{"TE", 1u << static_cast<int>(Position::TIGHT_END)};
+    const LineupSlot K{"K", 1u << static_cast<int>(Position::KICKER)};
+    const LineupSlot DEF{"DEF", 1u << static_cast<int>(Position::DEFENSE)};
+    const LineupSlot FLEX{"FLEX", RB.positions | WR.positions | TE.positions};
+    
+    // Slots for a lineup of the given size. Nine slots give the usual QB, 2 RB, 2 WR, TE,
+    // FLEX, K, DEF; smaller lineups keep the first slots of that order, larger ones add FLEX.
+    inline std::vector<LineupSlot> standard(int size) {
+        static const LineupSlot order[] = {QB, RB, WR, TE, FLEX, K, DEF, RB, WR};
+        std::vector<LineupSlot> slots;
+        for (int i = 0; i < size; ++i) {
+            slots.push_back(i < 9 ? order[i] : FLEX);
+        }
+        return slots;
+    }
+}
+
+// Projection for a player: the exact game distribution of the player's stat model, with
+// the mean pulled toward the player's own points per game as games are played
+inline Scoring::Projection projectPlayer(const Player& player, const ScoringRules& rules = ScoringRules::standard()) {
+    const double PRIOR_GAMES = 3.0;
+    Scoring::Projection projection = rules.projection(player.getModel());
+    if (player.getGamesPlayed() > 0) {
+        projection.mean = (projection.mean * PRIOR_GAMES + player.getFantasyPoints()) /
+                          (PRIOR_GAMES + player.getGamesPlayed());
+    }
+    return projection;
+}
+
+// Picks the lineup that fills every slot with distinct roster players and maximizes
+// either expected points or the normal-approximation probability of beating an opponent.
+// Depth-first branch and bound: slots are filled most-constrained first, candidates are
+// tried best-first, and a branch is cut when an optimistic bound (each remaining slot
+// gets its best candidate, ignoring conflicts) cannot beat the best lineup found.
+// Buffers are reused between calls; one optimizer per thread.
+class LineupOptimizer {
+public:
+    enum class Objective {
+        EXPECTED_POINTS,
+        WIN_PROBABILITY
+    };
+    
+    struct Result {
+        bool feasible = false;
+        std::vector<Player*> lineup;    // in slot order
+        double mean = 0.0;
+        double variance = 0.0;
+        double winProbability = 0.0;    // WIN_PROBABILITY objective only
+    };
+
+private:
+    std::vector<LineupSlot> slots;
+    Objective objective;
+    Scoring::Projection opponent;
+    
+    // Per-call search state
+    const std::vector<Scoring::Projection>* projections;
+    std::vector<size_t> slotOrder;
+    std::vector<std::vector<int>> candidates;   // roster indices per slot, best mean first
+    std::vector<double> boundMean;               // suffix sums over slotOrder
+    std::vector<double> boundMinVariance;
+    std::vector<double> boundMaxVariance;
+    std::vector<char> used;
+    std::vector<int> current;
+    std::vector<int> best;
+    double bestScore;
+    
+    double score(double mean, double variance) const {
+        if (objective == Objective::EXPECTED_POINTS) {
+            return mean;
+        }
+        return (mean - opponent.mean) / std::sqrt(std::max(variance + opponent.variance, 1e-9));
+    }
+    
+    // Best score any completion of the first `depth` slots could reach
+    double bound(size_t depth, double mean, double variance) const {
+        double optimistic = mean + boundMean[depth];
+        if (objective == Objective::EXPECTED_POINTS) {
+            return optimistic;
+        }
+        // z grows with the mean; a favorite wants the least variance, an underdog the most
+        double margin = optimistic - opponent.mean;
+        double spread = margin >= 0 ? variance + boundMinVariance[depth] : variance + boundMaxVariance[depth];
+        return margin / std::sqrt(std::max(spread + opponent.variance, 1e-9));
+    }
+    
+    void search(size_t depth, double mean, double variance) {
+        if (depth == slotOrder.size()) {
+            double value = score(mean, variance);
+            if (best.empty() || value > bestScore) {
+                bestScore = value;
+                best = current;
+            }
+            return;
+        }
+        for (int candidate : candidates[slotOrder[depth]]) {
+            if (used[candidate]) {
+                continue;
+            }
+            const Scoring::Projection& projection = (*projections)[candidate];
+            double nextMean = mean + projection.mean;
+            double nextVariance = variance + projection.variance;
+            if (!best.empty() && bound(depth + 1, nextMean, nextVariance) <= bestScore) {
+                // Candidates are sorted by mean, so for expected points no later one can do better
+                if (objective == Objective::EXPECTED_POINTS) {
+                    break;
+                }
+                continue;
+            }
+            used[candidate] = 1;
+            current[slotOrder[depth]] = candidate;
+            search(depth + 1, nextMean, nextVariance);
+            used[candidate] = 0;
+        }
+    }
+
+public:
+    explicit LineupOptimizer(std::vector<LineupSlot> slots)
+        : slots(std::move(slots)), objective(Objective::EXPECTED_POINTS), opponent{0.0, 0.0},
+          projections(nullptr), bestScore(0.0) {}
+    
+    const std::vector<LineupSlot>& getSlots() const { return slots; }
+    
+    void setObjective(Objective value, Scoring::Projection opponentProjection = {0.0, 0.0}) {
+        objective = value;
+        opponent = opponentProjection;
+    }
+    
+    // Optimize with one projection per roster entry
+    Result optimize(const std::vector<Player*>& roster, const std::vector<Scoring::Projection>& rosterProjections) {
+        Result result;
+        projections = &rosterProjections;
+        size_t slotCount = slots.size();
+        
+        candidates.resize(slotCount);
+        for (size_t s = 0; s < slotCount; ++s) {
+            candidates[s].clear();
+            for (size_t i = 0; i < roster.size(); ++i) {
+                if (slots[s].accepts(roster[i]->getPosition())) {
+                    candidates[s].push_back(static_cast<int>(i));
+                }
+            }
+            if (candidates[s].empty()) {
+                return result;
+            }
+            std::stable_sort(candidates[s].begin(), candidates[s].end(), [&rosterProjections](int a, int b) {
+                return rosterProjections[a].mean > rosterProjections[b].mean;
+            });
+        }
+        
+        slotOrder.resize(slotCount);
+        for (size_t s = 0; s < slotCount; ++s) {
+            slotOrder[s] = s;
+        }
+        std::stable_sort(slotOrder.begin(), slotOrder.end(), [this](size_t a, size_t b) {
+            return candidates[a].size() < candidates[b].size();
+        });
+        
+        boundMean.assign(slotCount + 1, 0.0);
+        boundMinVariance.assign(slotCount + 1, 0.0);
+        boundMaxVariance.assign(slotCount + 1, 0.0);
+        for (size_t depth = slotCount; depth-- > 0;) {
+            const std::vector<int>& options = candidates[slotOrder[depth]];
+            double maxMean = -std::numeric_limits<double>::infinity();
+            double minVariance = std::numeric_limits<double>::infinity();
+            double maxVariance = 0.0;
+            for (int candidate : options) {
+                maxMean = std::max(maxMean, rosterProjections[candidate].mean);
+                minVariance = std::min(minVariance, rosterProjections[candidate].variance);
+                maxVariance = std::max(maxVariance, rosterProjections[candidate].variance);
+            }
+            boundMean[depth] = boundMean[depth + 1] + maxMean;
+            boundMinVariance[depth] = boundMinVariance[depth + 1] + minVariance;
+            boundMaxVariance[depth] = boundMaxVariance[depth + 1] + maxVariance;
+        }
+        
+        used.assign(roster.size(), 0);
+        current.assign(slotCount, -1);
+        best.clear();
+        search(0, 0.0, 0.0);
+        if (best.empty()) {
+            return result;
+        }
+        
+        result.feasible = true;
+        for (int index : best) {
+            result.lineup.push_back(roster[index]);
+            result.mean += rosterProjections[index].mean;
+            result.variance += rosterProjections[index].variance;
+        }
+        if (objective == Objective::WIN_PROBABILITY) {
+            double spread = std::sqrt(std::max(result.variance + opponent.variance, 1e-9));
+            result.winProbability = 0.5 * std::erfc(-(result.mean - opponent.mean) / (spread * std::sqrt(2.0)));
+        }
+        return result;
+    }
+    
+    // Optimize using projectPlayer for each roster entry
+    Result optimize(const std::vector<Player*>& roster, const ScoringRules& rules = ScoringRules::standard()) {
+        std::vector<Scoring::Projection> rosterProjections;
+        rosterProjections.reserve(roster.size());
+        for (const Player* player : roster) {
+            rosterProjections.push_back(projectPlayer(*player, rules));
+        }
+        return optimize(roster, rosterProjections);
+    }
+};
+
+// Team class to store team information and roster
+class Team {
+private:
+    std::string name;
+    std::string owner;
+    std::vector<Player*> roster;
+    IdMap<Player*> rosterIndex;
+    std::vector<Player*> activeLineup;
+    int wins;
+    int losses;
+    double totalPoints;
+    Standings* standings;
+    int standingsId;
+    const ScoringRules* scoring;    // the league's rules
+
+public:
+    Team(const std::string& name, const std::string& owner)
+        : name(name), owner(owner), wins(0), losses(0), totalPoints(0.0), standings(nullptr), standingsId(-1),
+          scoring(&ScoringRules::standard()) {}
+    
+    // Register with a league table that is kept current as results arrive
+    void attachStandings(Standings* table) {
+        standings = table;
+        standingsId = table->add(this, wins, totalPoints);
+    }
+    
+    // Score games with these rules from now on; they must outlive the team
+    void setScoringRules(const ScoringRules* rules) {
+        scoring = rules;
+    }
+    
+    // Getters
+    std::string getName() const { return name; }
+    std::string getOwner() const { return owner; }
+    int getWins() const { return wins; }
+    int getLosses() const { return losses; }
+    double getTotalPoints() const { return totalPoints; }
+    
+    // Add a player to the roster
+    bool addPlayer(Player* player) {
+        // Check if player is already on the roster
+        if (!rosterIndex.insert(player->getId(), player)) {
+            return false;
+        }
+        roster.push_back(player);
+        return true;
+    }
+    
+    // Remove a player from the roster
+    bool removePlayer(int playerId) {
+        if (!rosterIndex.erase(playerId)) {
+            return false;
+        }
+        for (auto it = roster.begin(); it != roster.end(); ++it) {
+            if ((*it)->getId() == playerId) {
+                // Also remove from active lineup if present
+                for (auto lit = activeLineup.begin(); lit != activeLineup.end(); ++lit) {
+                    if ((*lit)->getId() == playerId) {
+                        activeLineup.erase(lit);
+                        break;
+                    }
+                }
+                roster.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Display team roster
+    void displayRoster(ReportWriter& report) const {
+        report.beginReport("TEAM ROSTER: " + name + " (Owner: " + owner + ")");
+        Player::beginTable(report);
+        for (const auto& player : roster) {
+            player->writeRow(report);
+        }
+        report.endTable();
+        
+        std::ostringstream summary;
+        summary << "\nTeam Record: " << wins << "-" << losses << "\n"
+                << "Total Points: " << std::fixed << std::setprecision(1) << totalPoints;
+        report.note(summary.str());
+        report.endReport();
+    }
+    
+    void displayRoster() const {
+        displayRoster(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Set active lineup
+    bool setLineup(const std::vector<int>& playerIds) {
+        activeLineup.clear();
+        
+        for (int id : playerIds) {
+            Player* const* player = rosterIndex.find(id);
+            if (!player) {
+                return false; // Player ID not found in roster
+            }
+            activeLineup.push_back(*player);
+        }
+        
+        return true;
+    }
+    
+    // Display active lineup
+    void displayLineup(ReportWriter& report) const {
+        report.beginReport("ACTIVE LINEUP: " + name + " (Owner: " + owner + ")");
+        
+        if (activeLineup.empty()) {
+            report.note("No active lineup set.");
+        } else {
+            Player::beginTable(report);
+            for (const auto& player : activeLineup) {
+                player->writeRow(report);
+            }
+            report.endTable();
+        }
+        report.endReport();
+    }
+    
+    void displayLineup() const {
+        displayLineup(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Simulate a game for all players in the active lineup and return this game's score.
+    // The team's season totals are only changed when the result is recorded.
+    double simulateGame(Random::Engine& gen = Random::engine()) {
+        double gameScore = 0.0;
+        
+        for (auto& player : activeLineup) {
+            gameScore += player->simulateGamePerformance(*scoring, gen).points;
+        }
+        
+        return gameScore;
+    }
+    
+    // Restore the record loaded from a snapshot
+    void restoreRecord(int savedWins, int savedLosses, double savedPoints) {
+        wins = savedWins;
+        losses = savedLosses;
+        totalPoints = savedPoints;
+        if (standings) {
+            standings->update(standingsId, wins, totalPoints);
+        }
+    }
+    
+    // Add one game's result and score to the season record
+    void recordGame(bool isWin, double gamePoints) {
+        if (isWin) {
+            wins++;
+        } else {
+            losses++;
+        }
+        totalPoints += gamePoints;
+        if (standings) {
+            standings->update(standingsId, wins, totalPoints);
+        }
+    }
+    
+    // Get roster size
+    int getRosterSize() const {
+        return roster.size();
+    }
+    
+    // Get lineup size
+    int getLineupSize() const {
+        return activeLineup.size();
+    }
+    
+    // Get player by ID from the roster
+    Player* getPlayerById(int id) {
+        Player* const* player = rosterIndex.find(id);
+        return player ? *player : nullptr;
+    }
+    
+    // Get all players
+    const std::vector<Player*>& getRoster() const {
+        return roster;
+    }
+    
+    // Get active lineup
+    const std::vector<Player*>& getActiveLineup() const {
+        return activeLineup;
+    }
+};
+
+// Matchup class to represent a game between two teams
+class Matchup {
+private:
+    Team* homeTeam;
+    Team* awayTeam;
+    double homeScore;
+    double awayScore;
+    bool isCompleted;
+    bool isPlayed;
+    uint64_t seed;
+    bool hasSeed;
+
+public:
+    Matchup(Team* home, Team* away)
+        : homeTeam(home), awayTeam(away), homeScore(0.0), awayScore(0.0), isCompleted(false),
+          isPlayed(false), seed(0), hasSeed(false) {}
+    
+    // Restore a result loaded from a snapshot
+    void restoreResult(double home, double away, bool completed) {
+        homeScore = home;
+        awayScore = away;
+        isCompleted = completed;
+        isPlayed = completed;
+    }
+    
+    // Fix the random stream used by simulate() so the result can be replayed
+    void setSeed(uint64_t value) {
+        seed = value;
+        hasSeed = true;
+    }
+    
+    // Take scores played elsewhere (e.g. in a LineupBatch); recordResult applies them
+    void setScores(double home, double away) {
+        homeScore = home;
+        awayScore = away;
+        isPlayed = true;
+    }
+    
+    // Play the game without recording it. Only the two teams and their players are
+    // touched, so matchups with disjoint teams can be played concurrently; a seeded
+    // matchup gives the same scores on any thread. Returns false if a lineup is missing.
+    bool play() {
+        Trace::Scope trace("matchup");
+        if (homeTeam->getLineupSize() == 0 || awayTeam->getLineupSize() == 0) {
+            return false;
+        }
+        
+        // A seeded game draws from its own stream and leaves the thread's engine alone
+        if (hasSeed) {
+            Random::Engine gen(seed);
+            homeScore = homeTeam->simulateGame(gen);
+            awayScore = awayTeam->simulateGame(gen);
+            Random::localDraws() += gen.getDraws();
+        } else {
+            homeScore = homeTeam->simulateGame();
+            awayScore = awayTeam->simulateGame();
+        }
+        isPlayed = true;
+        return true;
+    }
+    
+    // Apply a played game to the team records (and through them the league standings)
+    void recordResult() {
+        if (!isPlayed || isCompleted) {
+            return;
+        }
+        
+        // Update team records; in case of a tie, both teams get a loss (to keep it simple)
+        homeTeam->recordGame(homeScore > awayScore, homeScore);
+        awayTeam->recordGame(awayScore > homeScore, awayScore);
+        
+        isCompleted = true;
+    }
+    
+    // Simulate the matchup; returns false if it was already completed or was skipped for a
+    // missing lineup
+    bool simulate() {
+        if (isCompleted || !play()) {
+            return false;
+        }
+        recordResult();
+        return true;
+    }
+    
+    // Display matchup results
+    void displayResults(std::ostream& out = std::cout) const {
+        out << "\n==== MATCHUP RESULTS ====\n";
+        out << homeTeam->getName() << " vs " << awayTeam->getName() << '\n';
+        
+        if (isCompleted) {
+            out << "Score: " << std::fixed << std::setprecision(1) 
+                      << homeScore << " - " << awayScore << '\n';
+            
+            if (homeScore > awayScore) {
+                out << homeTeam->getName() << " wins!\n";
+            } else if (awayScore > homeScore) {
+                out << awayTeam->getName() << " wins!\n";
+            } else {
+                out << "It's a tie!\n";
+            }
+        } else {
+            out << "Matchup not yet simulated.\n";
+        }
+    }
+    
+    // Getters
+    Team* getHomeTeam() const { return homeTeam; }
+    Team* getAwayTeam() const { return awayTeam; }
+    double getHomeScore() const { return homeScore; }
+    double getAwayScore() const { return awayScore; }
+    bool getIsCompleted() const { return isCompleted; }
+    bool isSeeded() const { return hasSeed; }
+    uint64_t getSeed() const { return seed; }
+};
+
+// Plays many lineups in one call. Each game's lineups draw one random word per player from
+// the game's seeded stream, in lineup order: the words Matchup::play would use, so a
+// seeded matchup scores the same either way. The players are then simulated and scored
+// one position group at a time by PlayerStatsTable's column kernels, over buffers kept
+// between calls.
+class LineupBatch {
+private:
+    PlayerStatsTable table;
+    std::vector<Player*> players;       // every lineup's players, lineup after lineup; rows are tagged by index
+    std::vector<double> points;         // each player's game points, by the same index
+    std::vector<size_t> lineupEnds;     // lineup l is players [lineupEnds[l - 1], lineupEnds[l])
+    Random::Engine gen;
+
+public:
+    // Remove every lineup but keep the buffers for the next batch
+    void clear() {
+        table.clear();
+        players.clear();
+        lineupEnds.clear();
+    }
+    
+    // Start a game; the lineups added until the next call draw from this seed's stream
+    void beginGame(uint64_t seed) {
+        gen.seed(seed);
+    }
+    
+    // Add a lineup to the current game; returns its index
+    size_t addLineup(const std::vector<Player*>& lineup) {
+        for (Player* player : lineup) {
+            table.addDrawn(player->getPosition(), static_cast<uint32_t>(players.size()), &player->getModel(), gen());
+            players.push_back(player);
+        }
+        Random::localDraws() += lineup.size();
+        lineupEnds.push_back(players.size());
+        return lineupEnds.size() - 1;
+    }
+    
+    // Simulate and score one game for every player added
+    void simulate(const ScoringRules& rules) {
+        table.simulateDrawn();
+        table.score(rules);
+        points.assign(players.size(), 0.0);
+        table.scatterPoints(points.data());
+    }
+    
+    // A lineup's game score, its players' points added in lineup order
+    double score(size_t lineup) const {
+        double total = 0.0;
+        for (size_t i = lineup == 0 ? 0 : lineupEnds[lineup - 1]; i < lineupEnds[lineup]; ++i) {
+            total += points[i];
+        }
+        return total;
+    }
+    
+    // Add each simulated game to its player's season totals, walking the table group by
+    // group. Only the stats a position draws are gathered; the rest of its columns are zero.
+    void recordGames() const {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            const PlayerStatsTable::Group& group = table.group(static_cast<Position>(p));
+            const StatModel& prior = *StatModel::prior(static_cast<Position>(p));
+            const int statCount = prior.getStatCount();
+            StatLine line{};
+            for (size_t i = 0; i < group.size(); ++i) {
+                for (int s = 0; s < statCount; ++s) {
+                    line[prior.getStat(s)] = group.columns[prior.getStat(s)][i];
+                }
+                players[group.tags[i]]->recordGame(line, group.points[i]);
+            }
+        }
+    }
+    
+    size_t size() const { return players.size(); }
+};
+
+// Work-stealing thread pool. Each worker owns a deque: it pops its own work from the back
+// and steals from the front of the others when idle. wait() lets the caller help drain
+// the queues, so the pool also makes progress on a single-core machine.
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+    
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextQueue;
+    bool stopping;
+    
+    // Pop from our own queue first, then try to steal from the others
+    bool tryPop(size_t self, std::function<void()>& task) {
+        {
+            WorkQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkQueue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void runTask(std::function<void()>& task) {
+        task();
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            idle.notify_all();
+        }
+    }
+    
+    void workerLoop(size_t self) {
+        std::function<void()> task;
+        while (true) {
+            if (tryPop(self, task)) {
+                runTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(unsigned threadCount = std::thread::hardware_concurrency())
+        : queued(0), pending(0), nextQueue(0), stopping(false) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // Process-wide pool sized to the machine
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+    
+    size_t getThreadCount() const { return threads.size(); }
+    
+    // Queue a task; tasks are spread round-robin and rebalanced by stealing
+    void submit(std::function<void()> task) {
+        pending++;
+        WorkQueue& target = *queues[nextQueue++ % queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(target.mutex);
+            target.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        wake.notify_one();
+    }
+    
+    // Block until every submitted task has finished, running queued tasks meanwhile.
+    // Must not be called from inside a pool task.
+    void wait() {
+        std::function<void()> task;
+        while (pending > 0) {
+            if (tryPop(0, task)) {
+                runTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            idle.wait(lock, [this] { return pending == 0 || queued > 0; });
+        }
+    }
+    
+    // Run body(begin, end) over [0, count) in chunks of at most grain items. Waits only
+    // for its own chunks, so several threads can run parallel loops on the pool at once;
+    // a single chunk runs inline on the caller.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body body) {
+        grain = std::max<size_t>(1, grain);
+        if (count <= grain) {
+            if (count > 0) {
+                body(size_t(0), count);
+            }
+            return;
+        }
+        
+        std::atomic<size_t> remaining((count + grain - 1) / grain);
+        for (size_t begin = 0; begin < count; begin += grain) {
+            size_t end = std::min(count, begin + grain);
+            submit([this, &body, &remaining, begin, end] {
+                body(begin, end);
+                if (--remaining == 0) {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    idle.notify_all();
+                }
+            });
+        }
+        
+        std::function<void()> task;
+        while (remaining > 0) {
+            if (tryPop(0, task)) {
+                runTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            idle.wait(lock, [this, &remaining] { return remaining == 0 || queued > 0; });
+        }
+    }
+};
+
+// Intrusive multi-producer single-consumer queue (Vyukov). push() is wait-free: one
+// exchange on the tail. Only the owning consumer may call pop(). Node needs a
+// std::atomic<Node*> next member and a default constructor (one node is used as the stub).
+template <typename Node>
+class MpscQueue {
+private:
+    alignas(64) std::atomic<Node*> tail;
+    alignas(64) Node* head;
+    Node stub;
+    
+    void link(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = tail.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+public:
+    MpscQueue() : tail(&stub), head(&stub) {
+        stub.next.store(nullptr, std::memory_order_relaxed);
+    }
+    
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    
+    void push(Node* node) {
+        link(node);
+    }
+    
+    // Next node in push order, or nullptr if the queue is empty or a push is still
+    // being linked in
+    Node* pop() {
+        Node* first = head;
+        Node* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (!next) {
+                return nullptr;
+            }
+            head = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            head = next;
+            return first;
+        }
+        if (first != tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        link(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next) {
+            head = next;
+            return first;
+        }
+        return nullptr;
+    }
+};
+
+// A whole regular season planned up front as one flat array of (home, away) team indices,
+// week by week. Rounds come from the circle method, so each team meets every other team
+// once per cycle and, with an odd team count, sits out exactly one week per cycle. Home
+// games are balanced as the weeks are laid out. Optional divisions turn an evenly spread share of the weeks into
+// division-only rounds.
+class SeasonSchedule {
+public:
+    struct Game {
+        uint32_t home;
+        uint32_t away;
+    };
+    
+    // One week's games, iterable without copying
+    struct Week {
+        const Game* first;
+        const Game* last;
+        
+        const Game* begin() const { return first; }
+        const Game* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+private:
+    int teamCount;
+    std::vector<Game> games;
+    std::vector<uint32_t> weekStart;    // week w is games[weekStart[w], weekStart[w + 1])
+    
+    // Append one circle-method round over the given teams. Whoever has had fewer home games
+    // so far is at home; ties alternate with the round.
+    void appendRound(const std::vector<int>& members, int round, std::vector<int>& homeGames) {
+        const int count = static_cast<int>(members.size());
+        const int slots = count + (count % 2);    // an odd count gets a bye slot
+        if (slots < 2) {
+            return;
+        }
+        const int rotation = round % (slots - 1);
+        auto slotTeam = [slots, rotation](int slot) {
+            return slot == 0 ? 0 : 1 + (slot - 1 + rotation) % (slots - 1);
+        };
+        for (int i = 0; i < slots / 2; ++i) {
+            int home = slotTeam(i);
+            int away = slotTeam(slots - 1 - i);
+            if (home >= count || away >= count) {
+                continue;   // bye
+            }
+            home = members[home];
+            away = members[away];
+            if (homeGames[home] > homeGames[away] || (homeGames[home] == homeGames[away] && round % 2 == 1)) {
+                std::swap(home, away);
+            }
+            homeGames[home]++;
+            games.push_back({static_cast<uint32_t>(home), static_cast<uint32_t>(away)});
+        }
+    }
+
+public:
+    SeasonSchedule() : teamCount(0), weekStart(1, 0) {}
+    
+    // Plan `weeks` weeks for `teams` teams. The seed shuffles who meets whom when. If
+    // division is given (a division number per team), divisionWeeks of the weeks pair
+    // teams only within their division.
+    static SeasonSchedule build(int teams, int weeks, uint64_t seed,
+                                const std::vector<int>& division = {}, int divisionWeeks = 0) {
+        SeasonSchedule schedule;
+        schedule.teamCount = teams;
+        
+        std::vector<int> order(teams);
+        for (int t = 0; t < teams; ++t) {
+            order[t] = t;
+        }
+        Random::Engine gen(seed);
+        std::shuffle(order.begin(), order.end(), gen);
+        
+        std::vector<std::vector<int>> groups;
+        if (static_cast<int>(division.size()) == teams) {
+            for (int team : order) {
+                if (division[team] >= static_cast<int>(groups.size())) {
+                    groups.resize(division[team] + 1);
+                }
+                groups[division[team]].push_back(team);
+            }
+        }
+        divisionWeeks = groups.size() > 1 ? std::min(std::max(divisionWeeks, 0), weeks) : 0;
+        
+        schedule.games.reserve(static_cast<size_t>(weeks) * (teams / 2));
+        schedule.weekStart.reserve(weeks + 1);
+        std::vector<int> homeGames(teams, 0);
+        int leagueRound = 0;
+        int divisionRound = 0;
+        for (int w = 0; w < weeks; ++w) {
+            // Spread the division weeks evenly through the season
+            bool divisional = (w + 1) * divisionWeeks / weeks > w * divisionWeeks / weeks;
+            if (divisional) {
+                for (const auto& group : groups) {
+                    schedule.appendRound(group, divisionRound, homeGames);
+                }
+                divisionRound++;
+            } else {
+                schedule.appendRound(order, leagueRound++, homeGames);
+            }
+            schedule.weekStart.push_back(static_cast<uint32_t>(schedule.games.size()));
+        }
+        return schedule;
+    }
+    
+    int getTeamCount() const { return teamCount; }
+    int getWeekCount() const { return static_cast<int>(weekStart.size()) - 1; }
+    
+    // Games of a week, counted from 0
+    Week week(int index) const {
+        return {games.data() + weekStart[index], games.data() + weekStart[index + 1]};
+    }
+};
+
+// Everything the season simulator needs from a league, copied so simulation never
+// touches live League objects
+struct SeasonSnapshot {
+    std::vector<std::string> teamNames;
+    std::vector<std::vector<std::shared_ptr<const StatModel>>> lineups;    // models of each active lineup
+    std::vector<int> wins;                         // record so far
+    std::vector<double> points;                    // points so far
+    SeasonSchedule schedule;                       // the league's regular season
+    int firstWeek;                                 // first unplayed week, counted from 0
+    int playoffTeams;
+    ScoringRules scoring;
+    
+    SeasonSnapshot() : firstWeek(0), playoffTeams(4) {}
+    
+    // Index of the first team without an active lineup, or -1. Its games are skipped the
+    // way simulateWeek skips them, so odds are only meaningful once every team has one.
+    int missingLineup() const {
+        for (size_t t = 0; t < lineups.size(); ++t) {
+            if (lineups[t].empty()) {
+                return static_cast<int>(t);
+            }
+        }
+        return -1;
+    }
+};
+
+// Playoff and championship odds for one team
+struct TeamOdds {
+    std::string team;
+    double playoffProbability;
+    double championshipProbability;
+    double expectedWins;
+};
+
+// Headless Monte Carlo simulator: plays N independent copies of the rest of the season
+// in parallel and reports how often each team makes the playoffs and wins the title.
+// Results depend only on the seed, not on the number of threads.
+class SeasonSimulator {
+private:
+    ThreadPool& pool;
+    size_t seasonsPerTask;
+    
+    struct Tally {
+        std::vector<uint64_t> playoffs;
+        std::vector<uint64_t> titles;
+        std::vector<uint64_t> wins;
+        
+        explicit Tally(size_t teams) : playoffs(teams, 0), titles(teams, 0), wins(teams, 0) {}
+    };
+    
+    // Simulate seasons [first, first + count) with one engine per task
+    static void runSeasons(const SeasonSnapshot& snapshot, uint64_t seed, uint64_t taskIndex,
+                           size_t count, Tally& tally) {
+        const int teamCount = static_cast<int>(snapshot.teamNames.size());
+        Random::Engine gen(Random::deriveSeed(seed, taskIndex));
+        
+        // One row per lineup slot, tagged with its team
+        PlayerStatsTable table;
+        for (int t = 0; t < teamCount; ++t) {
+            for (const auto& model : snapshot.lineups[t]) {
+                table.add(model->getPosition(), static_cast<uint32_t>(t), StatLine{}, model.get());
+            }
+        }
+        
+        std::vector<int> wins(teamCount);
+        std::vector<double> points(teamCount);
+        std::vector<double> weekScores(teamCount);
+        std::vector<int> order(teamCount);
+        std::vector<int> bracket;
+        
+        auto playWeek = [&]() {
+            std::fill(weekScores.begin(), weekScores.end(), 0.0);
+            table.simulate(gen);
+            table.score(snapshot.scoring);
+            table.scatterPoints(weekScores.data());
+        };
+        
+        for (size_t season = 0; season < count; ++season) {
+            wins = snapshot.wins;
+            points = snapshot.points;
+            
+            for (int w = snapshot.firstWeek; w < snapshot.schedule.getWeekCount(); ++w) {
+                playWeek();
+                for (const SeasonSchedule::Game& game : snapshot.schedule.week(w)) {
+                    // simulateWeek skips a game missing a lineup: no points, no result
+                    if (snapshot.lineups[game.home].empty() || snapshot.lineups[game.away].empty()) {
+                        continue;
+                    }
+                    double home = weekScores[game.home];
+                    double away = weekScores[game.away];
+                    points[game.home] += home;
+                    points[game.away] += away;
+                    if (home > away) {
+                        wins[game.home]++;
+                    } else if (away > home) {
+                        wins[game.away]++;
+                    }
+                }
+            }
+            
+            // Seed the playoffs by wins, then points
+            for (int t = 0; t < teamCount; ++t) {
+                order[t] = t;
+                tally.wins[t] += wins[t];
+            }
+            int playoffTeams = std::min(snapshot.playoffTeams, teamCount);
+            std::partial_sort(order.begin(), order.begin() + playoffTeams, order.end(), [&](int a, int b) {
+                if (wins[a] != wins[b]) {
+                    return wins[a] > wins[b];
+                }
+                return points[a] > points[b];
+            });
+            
+            bracket.assign(order.begin(), order.begin() + playoffTeams);
+            for (int team : bracket) {
+                tally.playoffs[team]++;
+            }
+            
+            // Single elimination: best seed plays worst seed each round. A team without a
+            // lineup cannot win a game, so its opponent advances (the higher seed if both lack one).
+            while (bracket.size() > 1) {
+                playWeek();
+                size_t games = bracket.size() / 2;
+                size_t byes = bracket.size() - 2 * games;
+                std::vector<int> next(bracket.begin(), bracket.begin() + byes);
+                for (size_t g = 0; g < games; ++g) {
+                    int high = bracket[byes + g];
+                    int low = bracket[bracket.size() - 1 - g];
+                    bool lowWins = !snapshot.lineups[low].empty()
+                        && (snapshot.lineups[high].empty() || weekScores[low] > weekScores[high]);
+                    next.push_back(lowWins ? low : high);
+                }
+                bracket.swap(next);
+            }
+            if (!bracket.empty()) {
+                tally.titles[bracket.front()]++;
+            }
+        }
+    }
+
+public:
+    explicit SeasonSimulator(ThreadPool& pool = ThreadPool::shared(), size_t seasonsPerTask = 2048)
+        : pool(pool), seasonsPerTask(seasonsPerTask) {}
+    
+    // Run the given number of seasons and return odds for every team in snapshot order
+    std::vector<TeamOdds> run(const SeasonSnapshot& snapshot, size_t seasons, uint64_t seed) {
+        Trace::Scope trace("seasonOdds");
+        const size_t teamCount = snapshot.teamNames.size();
+        Tally total(teamCount);
+        std::mutex totalMutex;
+        
+        size_t tasks = (seasons + seasonsPerTask - 1) / seasonsPerTask;
+        pool.parallelFor(tasks, 1, [&](size_t begin, size_t end) {
+            for (size_t task = begin; task < end; ++task) {
+                size_t count = std::min(seasonsPerTask, seasons - task * seasonsPerTask);
+                Tally local(teamCount);
+                runSeasons(snapshot, seed, task, count, local);
+                
+                std::lock_guard<std::mutex> lock(totalMutex);
+                for (size_t t = 0; t < teamCount; ++t) {
+                    total.playoffs[t] += local.playoffs[t];
+                    total.titles[t] += local.titles[t];
+                    total.wins[t] += local.wins[t];
+                }
+            }
+        });
+        
+        std::vector<TeamOdds> odds;
+        double n = seasons > 0 ? static_cast<double>(seasons) : 1.0;
+        for (size_t t = 0; t < teamCount; ++t) {
+            odds.push_back({snapshot.teamNames[t], total.playoffs[t] / n, total.titles[t] / n, total.wins[t] / n});
+        }
+        return odds;
+    }
+};
+
+// Versioned, fixed-layout binary snapshot of a league. Every record has a fixed size and
+// natural alignment, so a mapped file can be read in place through MappedSnapshot.
+// Layout: Header | PlayerRecord[playerCount] | TeamRecord[teamCount] |
+//         int32 member IDs[memberCount] | MatchupRecord[matchupCount]
+namespace Snapshot {
+    const uint32_t MAGIC = 0x4C465354;    // "TSFL"
+    const uint32_t VERSION = 3;
+    const size_t NAME_LENGTH = 48;
+    const size_t STAT_SLOTS = 16;         // room for new stat columns without a layout change
+    const int32_t MAX_ROSTER = 1024;      // bound on the roster and lineup sizes a file may ask for
+    
+    static_assert(STAT_COUNT <= STAT_SLOTS, "Snapshot::PlayerRecord has no room for all stats");
+    
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t playerCount;
+        uint32_t teamCount;
+        uint32_t memberCount;
+        uint32_t matchupCount;
+        int32_t currentWeek;
+        int32_t maxTeams;
+        int32_t rosterSize;
+        int32_t lineupSize;
+        int32_t seasonWeeks;
+        int32_t playoffTeams;
+        uint64_t seed;
+        uint32_t hasSeed;
+        uint32_t scheduleSeed;
+        int32_t divisionCount;
+        int32_t divisionWeeks;
+        char leagueName[NAME_LENGTH];
+    };
+    
+    struct PlayerRecord {
+        int32_t id;
+        int32_t position;
+        int32_t owner;        // team index, or -1 while available
+        int32_t gamesPlayed;
+        int32_t stats[STAT_SLOTS];
+        double fantasyPoints;
+        int32_t historyGames;     // imported history behind the player's stat model
+        int32_t history[STAT_SLOTS];
+        char name[NAME_LENGTH];
+        char team[NAME_LENGTH];
+    };
+    
+    struct TeamRecord {
+        int32_t wins;
+        int32_t losses;
+        double totalPoints;
+        uint32_t rosterStart;     // index into the member ID array
+        uint32_t rosterCount;
+        uint32_t lineupStart;
+        uint32_t lineupCount;
+        char name[NAME_LENGTH];
+        char owner[NAME_LENGTH];
+    };
+    
+    struct MatchupRecord {
+        int32_t home;             // team indices
+        int32_t away;
+        double homeScore;
+        double awayScore;
+        uint64_t seed;
+        uint32_t hasSeed;
+        uint32_t completed;
+    };
+    
+    // Copy a string into a fixed, NUL-terminated field
+    inline void copyName(char* field, const std::string& value) {
+        size_t length = std::min(value.size(), NAME_LENGTH - 1);
+        std::memcpy(field, value.data(), length);
+        std::memset(field + length, 0, NAME_LENGTH - length);
+    }
+    
+    // Whether copyName keeps every byte of a string, so readName returns it unchanged
+    inline bool fitsName(std::string_view value) {
+        return value.size() < NAME_LENGTH && value.find('\0') == std::string_view::npos;
+    }
+    
+    inline std::string readName(const char* field) {
+        return std::string(field, strnlen(field, NAME_LENGTH));
+    }
+    
+    // FNV-1a over a whole snapshot; identifies the snapshot a transaction log continues from
+    inline uint64_t digest(const unsigned char* data, size_t length) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+    
+    // Write a snapshot image to a temporary file, sync it and rename it over path, so an
+    // existing snapshot is never left half-written
+    inline bool writeFile(const std::string& path, const std::string& image) {
+        std::string tempPath = path + ".tmp";
+        FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+#ifndef _WIN32
+        // The rename must not reach the disk before the data does
+        ok = ok && std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        return ok && std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+}
+
+// Read-only view of a snapshot file. On POSIX systems the file is mmap'ed and records are
+// used in place; elsewhere it is read into memory once.
+class MappedSnapshot {
+private:
+    const unsigned char* data;
+    size_t length;
+    std::vector<unsigned char> buffer;
+    std::string error;
+#ifndef _WIN32
+    void* mapping;
+#endif
+    
+    template <typename Record>
+    const Record* at(size_t offset) const {
+        return reinterpret_cast<const Record*>(data + offset);
+    }
+    
+    size_t playerOffset() const { return sizeof(Snapshot::Header); }
+    size_t teamOffset() const { return playerOffset() + header().playerCount * sizeof(Snapshot::PlayerRecord); }
+    size_t memberOffset() const { return teamOffset() + header().teamCount * sizeof(Snapshot::TeamRecord); }
+    size_t matchupOffset() const { return memberOffset() + header().memberCount * sizeof(int32_t); }
+    
+    bool validate() {
+        if (length < sizeof(Snapshot::Header)) {
+            error = "file is too small to be a league snapshot";
+            return false;
+        }
+        if (header().magic != Snapshot::MAGIC) {
+            error = "not a league snapshot";
+            return false;
+        }
+        if (header().version != Snapshot::VERSION) {
+            error = "unsupported snapshot version " + std::to_string(header().version);
+            return false;
+        }
+        if (matchupOffset() + header().matchupCount * sizeof(Snapshot::MatchupRecord) != length) {
+            error = "snapshot is truncated or corrupt";
+            return false;
+        }
+        return validateRecords();
+    }
+    
+    bool corrupt(const std::string& what) {
+        error = "snapshot is corrupt: " + what;
+        return false;
+    }
+    
+    // The loader trusts every count, index and ID in the file, so check them all here:
+    // each owned player is on exactly its owner's roster, each lineup is drawn from its
+    // roster, and every team index is in range.
+    bool validateRecords() {
+        const Snapshot::Header& head = header();
+        if (head.lineupSize < 1 || head.lineupSize > head.rosterSize || head.rosterSize > Snapshot::MAX_ROSTER) {
+            return corrupt("bad roster or lineup size");
+        }
+        if (head.maxTeams < 0 || head.teamCount > static_cast<uint32_t>(head.maxTeams)) {
+            return corrupt("more teams than the league allows");
+        }
+        if (head.currentWeek < 1 || head.seasonWeeks < 1 || head.playoffTeams < 1
+            || head.divisionCount < 1 || head.divisionWeeks < 0) {
+            return corrupt("bad season format");
+        }
+        
+        // Player IDs are unique and not one of the IDs IdMap reserves
+        std::unordered_map<int32_t, uint32_t> recordOf;
+        recordOf.reserve(head.playerCount);
+        std::vector<uint32_t> owned(head.teamCount, 0);
+        for (uint32_t i = 0; i < head.playerCount; ++i) {
+            const Snapshot::PlayerRecord& record = players()[i];
+            if (record.id <= std::numeric_limits<int32_t>::min() + 1) {
+                return corrupt("reserved player ID " + std::to_string(record.id));
+            }
+            if (!recordOf.emplace(record.id, i).second) {
+                return corrupt("duplicate player ID " + std::to_string(record.id));
+            }
+            if (record.position < 0 || record.position >= POSITION_COUNT) {
+                return corrupt("player " + std::to_string(record.id) + " has an unknown position");
+            }
+            if (record.owner < -1 || record.owner >= static_cast<int64_t>(head.teamCount)) {
+                return corrupt("player " + std::to_string(record.id) + " has an unknown owner");
+            }
+            if (record.owner >= 0) {
+                owned[record.owner]++;
+            }
+        }
+        
+        std::unordered_set<std::string> names;
+        std::vector<uint32_t> seen(head.playerCount, 0);    // 1 + the last team that listed the player
+        std::vector<uint32_t> inLineup(head.playerCount, 0);
+        for (uint32_t t = 0; t < head.teamCount; ++t) {
+            const Snapshot::TeamRecord& team = teams()[t];
+            std::string label = "team " + std::to_string(t);
+            if (!names.insert(Snapshot::readName(team.name)).second) {
+                return corrupt("duplicate team name \"" + Snapshot::readName(team.name) + "\"");
+            }
+            if (static_cast<uint64_t>(team.rosterStart) + team.rosterCount > head.memberCount
+                || static_cast<uint64_t>(team.lineupStart) + team.lineupCount > head.memberCount
+                || team.rosterCount != owned[t] || team.rosterCount > static_cast<uint32_t>(head.rosterSize)
+                || team.lineupCount > static_cast<uint32_t>(head.lineupSize)) {
+                return corrupt(label + " has a bad roster or lineup range");
+            }
+            for (uint32_t m = 0; m < team.rosterCount; ++m) {
+                auto found = recordOf.find(members()[team.rosterStart + m]);
+                if (found == recordOf.end() || players()[found->second].owner != static_cast<int32_t>(t)
+                    || seen[found->second] == t + 1) {
+                    return corrupt(label + " lists a player it does not own");
+                }
+                seen[found->second] = t + 1;
+            }
+            for (uint32_t m = 0; m < team.lineupCount; ++m) {
+                auto found = recordOf.find(members()[team.lineupStart + m]);
+                if (found == recordOf.end() || seen[found->second] != t + 1 || inLineup[found->second] == t + 1) {
+                    return corrupt(label + " starts a player not on its roster");
+                }
+                inLineup[found->second] = t + 1;
+            }
+        }
+        
+        // A week's matchups are played concurrently, so no team may be in two of them
+        std::vector<char> scheduled(head.teamCount, 0);
+        for (uint32_t i = 0; i < head.matchupCount; ++i) {
+            const Snapshot::MatchupRecord& matchup = matchups()[i];
+            if (matchup.home < 0 || matchup.away < 0 || matchup.home == matchup.away
+                || matchup.home >= static_cast<int64_t>(head.teamCount) || matchup.away >= static_cast<int64_t>(head.teamCount)) {
+                return corrupt("matchup " + std::to_string(i) + " has an unknown team");
+            }
+            if (scheduled[matchup.home] || scheduled[matchup.away]) {
+                return corrupt("matchup " + std::to_string(i) + " has a team that already plays this week");
+            }
+            scheduled[matchup.home] = scheduled[matchup.away] = 1;
+        }
+        return true;
+    }
+
+public:
+    explicit MappedSnapshot(const std::string& path) : data(nullptr), length(0) {
+#ifndef _WIN32
+        mapping = nullptr;
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "cannot open " + path;
+            return;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            length = static_cast<size_t>(info.st_size);
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                mapping = mapped;
+                data = static_cast<const unsigned char*>(mapped);
+            }
+        }
+        ::close(fd);
+        if (!data) {
+            length = 0;
+            error = "cannot map " + path;
+            return;
+        }
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "cannot open " + path;
+            return;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        length = buffer.size();
+#endif
+        if (!validate()) {
+            data = nullptr;
+        }
+    }
+    
+    ~MappedSnapshot() {
+#ifndef _WIN32
+        if (mapping) {
+            ::munmap(mapping, length);
+        }
+#endif
+    }
+    
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+    
+    bool isValid() const { return data != nullptr; }
+    const std::string& getError() const { return error; }
+    
+    const Snapshot::Header& header() const { return *at<Snapshot::Header>(0); }
+    const Snapshot::PlayerRecord* players() const { return at<Snapshot::PlayerRecord>(playerOffset()); }
+    const Snapshot::TeamRecord* teams() const { return at<Snapshot::TeamRecord>(teamOffset()); }
+    const int32_t* members() const { return at<int32_t>(memberOffset()); }
+    const Snapshot::MatchupRecord* matchups() const { return at<Snapshot::MatchupRecord>(matchupOffset()); }
+    
+    uint64_t digest() const {
+        return Snapshot::digest(data, length);
+    }
+};
+
+// Append-only binary log of league mutations (a write-ahead log). Each record is framed as
+// {payload length, checksum} + op + payload. append() only copies the frame into a buffer;
+// a background thread writes everything buffered so far with one write and one fsync, so
+// a burst of appends shares a single disk sync (group commit). Replay stops at the first
+// torn or corrupt frame, which is where a crash interrupted the last write.
+class TransactionLog {
+public:
+    enum class Op : uint8_t {
+        REGISTER_TEAM = 1,
+        DRAFT,
+        DROP,
+        ADD,
+        CLAIM,
+        PROCESS_WAIVERS,
+        TRADE,
+        LINEUP,
+        GENERATE_MATCHUPS,
+        SIMULATE_WEEK,
+        // Settings: replaying these twice is harmless
+        SEED,
+        SEASON_FORMAT,
+        DIVISION_FORMAT,
+        SCORING,
+        WAIVER_ORDER
+    };
+    
+    static bool isSetting(Op op) { return op >= Op::SEED; }
+    
+    // Payload builder; values are stored in native byte order, like snapshots
+    class Record {
+    private:
+        std::string bytes;
+        
+        template <typename Value>
+        Record& put(Value value) {
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            return *this;
+        }
+
+    public:
+        Record& add(int32_t value) { return put(value); }
+        Record& add(uint64_t value) { return put(value); }
+        Record& add(double value) { return put(value); }
+        
+        Record& add(std::string_view text) {
+            put(static_cast<uint32_t>(text.size()));
+            bytes.append(text.data(), text.size());
+            return *this;
+        }
+        
+        Record& add(const std::vector<int>& ids) {
+            put(static_cast<uint32_t>(ids.size()));
+            for (int id : ids) {
+                put(static_cast<int32_t>(id));
+            }
+            return *this;
+        }
+        
+        const std::string& getBytes() const { return bytes; }
+    };
+    
+    // Payload parser. Reading past the end yields zeros and clears ok().
+    class Reader {
+    private:
+        const char* cursor;
+        const char* end;
+        bool valid;
+        
+        template <typename Value>
+        Value get() {
+            Value value{};
+            if (static_cast<size_t>(end - cursor) < sizeof(value)) {
+                valid = false;
+                cursor = end;
+                return value;
+            }
+            std::memcpy(&value, cursor, sizeof(value));
+            cursor += sizeof(value);
+            return value;
+        }
+
+    public:
+        Reader(const char* data, size_t length) : cursor(data), end(data + length), valid(true) {}
+        
+        int32_t readInt() { return get<int32_t>(); }
+        uint64_t readU64() { return get<uint64_t>(); }
+        double readDouble() { return get<double>(); }
+        
+        std::string readString() {
+            uint32_t length = get<uint32_t>();
+            if (static_cast<size_t>(end - cursor) < length) {
+                valid = false;
+                cursor = end;
+                return std::string();
+            }
+            std::string text(cursor, length);
+            cursor += length;
+            return text;
+        }
+        
+        std::vector<int> readIds() {
+            uint32_t count = get<uint32_t>();
+            std::vector<int> ids;
+            ids.reserve(std::min<size_t>(count, static_cast<size_t>(end - cursor) / sizeof(int32_t)));
+            for (uint32_t i = 0; i < count && valid; ++i) {
+                ids.push_back(get<int32_t>());
+            }
+            return ids;
+        }
+        
+        bool ok() const { return valid; }
+    };
+    
+    static const uint32_t MAGIC = 0x4C575354;    // "TSWL"
+    static const uint32_t VERSION = 1;
+
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t snapshotDigest;    // the snapshot this log continues from
+    };
+    
+    struct FrameHeader {
+        uint32_t length;            // op byte + payload
+        uint32_t checksum;
+    };
+    
+    FILE* file;                     // opened by the flusher; null until then or if that failed
+    std::string path;
+    std::string snapshotPath;
+    std::string image;              // snapshot the log starts from, until it is written
+    std::unique_ptr<TransactionLog> previous;
+    std::string pending;            // frames not yet handed to the flusher
+    std::string writing;            // frames being written; swapped with pending
+    uint64_t appended;              // bytes appended, including the file header
+    uint64_t durable;               // bytes written and synced
+    bool stopping;
+    bool failed;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable synced;
+    std::thread flusher;
+    
+    // FNV-1a, enough to catch a torn or garbled frame
+    static uint32_t checksum(const char* data, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return hash;
+    }
+    
+    static bool syncFile(FILE* handle) {
+        if (std::fflush(handle) != 0) {
+            return false;
+        }
+#ifndef _WIN32
+        return ::fsync(::fileno(handle)) == 0;
+#else
+        return true;
+#endif
+    }
+    
+    // The flusher's first job: close the previous log, which writes out its tail, then
+    // write the snapshot, then sync the new log's header (carrying the snapshot's digest)
+    // under a temporary name and rename it over the previous log
+    bool open() {
+        previous.reset();
+        if (!Snapshot::writeFile(snapshotPath, image)) {
+            return false;
+        }
+        FileHeader header{MAGIC, VERSION, Snapshot::digest(reinterpret_cast<const unsigned char*>(image.data()), image.size())};
+        std::string().swap(image);
+        
+        std::string tempPath = path + ".tmp";
+        FILE* handle = std::fopen(tempPath.c_str(), "wb");
+        if (!handle) {
+            return false;
+        }
+        if (std::fwrite(&header, sizeof(header), 1, handle) != 1 || !syncFile(handle)
+            || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::fclose(handle);
+            return false;
+        }
+        file = handle;
+        return true;
+    }
+    
+    void flushLoop() {
+        bool opened = open();
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!opened) {
+            failed = true;
+            synced.notify_all();
+        }
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            writing.swap(pending);
+            uint64_t target = appended;
+            lock.unlock();
+            
+            // Appends that arrive meanwhile gather in pending and go out with the next sync
+            bool ok = file && std::fwrite(writing.data(), 1, writing.size(), file) == writing.size() && syncFile(file);
+            writing.clear();
+            
+            lock.lock();
+            failed = failed || !ok;
+            durable = target;
+            synced.notify_all();
+        }
+    }
+    
+    TransactionLog(const std::string& path, const std::string& snapshotPath, std::string image,
+                   std::unique_ptr<TransactionLog> previous)
+        : file(nullptr), path(path), snapshotPath(snapshotPath), image(std::move(image)), previous(std::move(previous)),
+          appended(sizeof(FileHeader)), durable(sizeof(FileHeader)), stopping(false), failed(false) {
+        flusher = std::thread(&TransactionLog::flushLoop, this);
+    }
+
+public:
+    ~TransactionLog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        if (file) {
+            std::fclose(file);
+        }
+    }
+    
+    TransactionLog(const TransactionLog&) = delete;
+    TransactionLog& operator=(const TransactionLog&) = delete;
+    
+    // Start an empty log at path on top of a snapshot image, replacing previous (if any).
+    // Everything that touches the disk runs on the flusher thread (see open()), so this
+    // returns at once and records appended meanwhile wait in memory. A crash leaves the
+    // old snapshot and log, the new snapshot with the old log (whose digest no longer
+    // matches), or the new pair. A failure shows up in append() and sync().
+    static std::unique_ptr<TransactionLog> start(const std::string& path, const std::string& snapshotPath,
+                                                 std::string image, std::unique_ptr<TransactionLog> previous = nullptr) {
+        return std::unique_ptr<TransactionLog>(new TransactionLog(path, snapshotPath, std::move(image), std::move(previous)));
+    }
+    
+    // Call visit(op, reader) for every intact record of the log at path. Returns false if
+    // the file is missing or is not a log; digest receives the header's snapshot digest.
+    template <typename Visitor>
+    static bool replay(const std::string& path, uint64_t& digest, Visitor&& visit) {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            return false;
+        }
+        std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        FileHeader header;
+        if (bytes.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION) {
+            return false;
+        }
+        digest = header.snapshotDigest;
+        
+        size_t offset = sizeof(header);
+        FrameHeader frame;
+        while (bytes.size() - offset >= sizeof(frame)) {
+            std::memcpy(&frame, bytes.data() + offset, sizeof(frame));
+            const char* body = bytes.data() + offset + sizeof(frame);
+            if (frame.length == 0 || frame.length > bytes.size() - offset - sizeof(frame)
+                || checksum(body, frame.length) != frame.checksum) {
+                break;
+            }
+            Reader reader(body + 1, frame.length - 1);
+            visit(static_cast<Op>(body[0]), reader);
+            offset += sizeof(frame) + frame.length;
+        }
+        return true;
+    }
+    
+    // Queue a record for the next group commit; the caller never waits for the disk.
+    // Returns false, dropping the record, once a write has failed.
+    bool append(Op op, const Record& record) {
+        const std::string& payload = record.getBytes();
+        FrameHeader frame;
+        frame.length = static_cast<uint32_t>(payload.size() + 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failed) {
+                return false;
+            }
+            size_t start = pending.size();
+            pending.append(sizeof(frame), '\0');
+            pending += static_cast<char>(op);
+            pending += payload;
+            frame.checksum = checksum(pending.data() + start + sizeof(frame), frame.length);
+            std::memcpy(&pending[start], &frame, sizeof(frame));
+            appended += sizeof(frame) + frame.length;
+        }
+        wake.notify_one();
+        return true;
+    }
+    
+    // Block until every record appended so far is on disk; false if a write failed
+    bool sync() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t target = appended;
+        synced.wait(lock, [this, target] { return durable >= target || failed; });
+        return !failed;
+    }
+    
+    // Bytes in the log, including records not yet synced
+    uint64_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return appended;
+    }
+};
+
+// Streaming player-universe importer for CSV (header row + one player per line) and JSON
+// (a sequence or array of flat objects). The file is read in fixed-size chunks; each chunk
+// is split into records on one thread, parsed in parallel on the shared pool, and handed
+// to the sink in file order, so memory stays bounded by the chunk size.
+//
+// Recognized fields: id, name, position (QB/RB/WR/TE/K/DEF), team, games, fantasy_points
+// and the stat names from statName() (passing_yards, rushing_tds, ...).
+class PlayerImporter {
+public:
+    struct Record {
+        int id;
+        std::string name;
+        Position position;
+        std::string_view team;      // points into the current chunk; valid only inside the sink
+        int gamesPlayed;
+        StatLine stats;
+        double fantasyPoints;
+        bool hasFantasyPoints;
+    };
+    
+    struct Result {
+        size_t imported;
+        size_t skipped;
+        std::string error;
+        
+        Result() : imported(0), skipped(0) {}
+    };
+    
+    enum class Format { CSV, JSON };
+
+private:
+    // Field slots a CSV column or JSON key can map to
+    enum Field { FIELD_ID = STAT_COUNT, FIELD_NAME, FIELD_POSITION, FIELD_TEAM, FIELD_GAMES, FIELD_POINTS, FIELD_IGNORED };
+    
+    static const size_t CHUNK_BYTES = 1 << 20;
+    static const size_t RECORDS_PER_TASK = 2048;
+    
+    ThreadPool& pool;
+    
+    static int fieldForName(std::string_view key) {
+        if (key == "id") return FIELD_ID;
+        if (key == "name") return FIELD_NAME;
+        if (key == "position" || key == "pos") return FIELD_POSITION;
+        if (key == "team") return FIELD_TEAM;
+        if (key == "games" || key == "games_played") return FIELD_GAMES;
+        if (key == "fantasy_points" || key == "points") return FIELD_POINTS;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            if (key == statName(static_cast<Stat>(s))) return s;
+        }
+        return FIELD_IGNORED;
+    }
+    
+    static bool parsePosition(std::string_view text, Position& pos) {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            if (text == positionToString(static_cast<Position>(p))) {
+                pos = static_cast<Position>(p);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+        return text;
+    }
+    
+    // Store one field value into a record; returns false if the value is malformed
+    static bool assignField(Record& record, int field, std::string_view value, std::string* scratch) {
+        value = trim(value);
+        switch (field) {
+            case FIELD_NAME:
+                record.name = scratch ? *scratch : std::string(value);
+                return !record.name.empty();
+            case FIELD_TEAM:
+                record.team = value;
+                return true;
+            case FIELD_POSITION:
+                return parsePosition(value, record.position);
+            case FIELD_POINTS: {
+                auto parsed = std::from_chars(value.data(), value.data() + value.size(), record.fantasyPoints);
+                record.hasFantasyPoints = parsed.ec == std::errc();
+                return value.empty() || record.hasFantasyPoints;
+            }
+            case FIELD_IGNORED:
+                return true;
+            default: {
+                if (value.empty()) {
+                    return field != FIELD_ID;
+                }
+                int number = 0;
+                auto parsed = std::from_chars(value.data(), value.data() + value.size(), number);
+                if (parsed.ec != std::errc() || parsed.ptr != value.data() + value.size()) {
+                    return false;
+                }
+                if (field == FIELD_ID) record.id = number;
+                else if (field == FIELD_GAMES) record.gamesPlayed = number;
+                else record.stats[field] = number;
+                return true;
+            }
+        }
+    }
+    
+    static void resetRecord(Record& record) {
+        record.id = -1;
+        record.name.clear();
+        record.position = Position::QUARTERBACK;
+        record.team = std::string_view();
+        record.gamesPlayed = 0;
+        record.stats.fill(0);
+        record.fantasyPoints = 0.0;
+        record.hasFantasyPoints = false;
+    }
+    
+    // Parse one CSV line using the header's column mapping
+    static bool parseCsvRecord(std::string_view line, const std::vector<int>& columns, Record& record) {
+        resetRecord(record);
+        bool hasPosition = false;
+        size_t column = 0;
+        size_t pos = 0;
+        std::string unquoted;
+        while (pos <= line.size()) {
+            std::string_view value;
+            std::string* scratch = nullptr;
+            if (pos < line.size() && line[pos] == '"') {
+                unquoted.clear();
+                size_t i = pos + 1;
+                for (; i < line.size(); ++i) {
+                    if (line[i] == '"') {
+                        if (i + 1 < line.size() && line[i + 1] == '"') {
+                            unquoted += '"';
+                            ++i;
+                        } else {
+                            break;
+                        }
+                    } else {
+                        unquoted += line[i];
+                    }
+                }
+                value = std::string_view(line.data() + pos + 1, i - pos - 1);
+                scratch = &unquoted;
+                pos = line.find(',', i);
+            } else {
+                size_t end = line.find(',', pos);
+                value = line.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+                pos = end;
+            }
+            if (column < columns.size()) {
+                if (columns[column] == FIELD_POSITION) hasPosition = true;
+                if (!assignField(record, columns[column], value, scratch)) {
+                    return false;
+                }
+            }
+            column++;
+            if (pos == std::string_view::npos) {
+                break;
+            }
+            pos++;
+        }
+        // IDs must be positive, which also keeps out the two values IdMap reserves; names
+        // must fit a snapshot
+        return record.id > 0 && !record.name.empty() && hasPosition
+            && Snapshot::fitsName(record.name) && Snapshot::fitsName(record.team);
+    }
+    
+    // Parse one flat JSON object: {"key": value, ...}
+    static bool parseJsonRecord(std::string_view text, Record& record) {
+        resetRecord(record);
+        bool hasPosition = false;
+        size_t pos = text.find('{');
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        pos++;
+        std::string decoded;
+        
+        auto skipSpace = [&]() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        };
+        // Read a string starting at the opening quote; escapes are decoded into 'decoded'
+        auto readString = [&](std::string_view& out, bool& escaped) {
+            size_t start = ++pos;
+            escaped = false;
+            decoded.clear();
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\' && pos + 1 < text.size()) {
+                    escaped = true;
+                    pos++;
+                    char c = text[pos];
+                    decoded += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+                } else {
+                    decoded += text[pos];
+                }
+                pos++;
+            }
+            out = text.substr(start, pos - start);
+            pos++;
+            return pos <= text.size();
+        };
+        
+        while (true) {
+            skipSpace();
+            if (pos >= text.size()) return false;
+            if (text[pos] == '}') break;
+            if (text[pos] == ',') { pos++; continue; }
+            if (text[pos] != '"') return false;
+            
+            std::string_view key;
+            bool escaped;
+            if (!readString(key, escaped)) return false;
+            int field = fieldForName(key);
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') return false;
+            pos++;
+            skipSpace();
+            if (pos >= text.size()) return false;
+            
+            std::string_view value;
+            if (text[pos] == '"') {
+                if (!readString(value, escaped)) return false;
+                std::string decodedValue = decoded;
+                if (!assignField(record, field, value, escaped ? &decodedValue : nullptr)) return false;
+            } else {
+                size_t start = pos;
+                while (pos < text.size() && text[pos] != ',' && text[pos] != '}') pos++;
+                value = text.substr(start, pos - start);
+                if (trim(value) == "null") value = std::string_view();
+                if (!assignField(record, field, value, nullptr)) return false;
+            }
+            if (field == FIELD_POSITION) hasPosition = true;
+        }
+        return record.id > 0 && !record.name.empty() && hasPosition
+            && Snapshot::fitsName(record.name) && Snapshot::fitsName(record.team);
+    }
+    
+    // Split complete records out of a buffer; returns bytes consumed. Boundaries respect
+    // quoted strings so commas and braces inside names do not split records.
+    static size_t splitRecords(std::string_view buffer, Format format, bool finalChunk,
+                               std::vector<std::string_view>& records) {
+        size_t consumed = 0;
+        bool inString = false;
+        bool escape = false;
+        int depth = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            char c = buffer[i];
+            if (format == Format::CSV) {
+                if (c == '"') {
+                    inString = !inString;
+                } else if (c == '\n' && !inString) {
+                    if (i > start) records.push_back(buffer.substr(start, i - start));
+                    start = consumed = i + 1;
+                }
+            } else {
+                if (inString) {
+                    if (escape) escape = false;
+                    else if (c == '\\') escape = true;
+                    else if (c == '"') inString = false;
+                } else if (c == '"') {
+                    inString = true;
+                } else if (c == '{') {
+                    if (depth++ == 0) start = i;
+                } else if (c == '}' && depth > 0) {
+                    if (--depth == 0) {
+                        records.push_back(buffer.substr(start, i + 1 - start));
+                        consumed = i + 1;
+                    }
+                }
+            }
+        }
+        if (finalChunk && format == Format::CSV && start < buffer.size()) {
+            std::string_view tail = trim(buffer.substr(start));
+            if (!tail.empty()) records.push_back(tail);
+            consumed = buffer.size();
+        }
+        return consumed;
+    }
+
+public:
+    explicit PlayerImporter(ThreadPool& pool = ThreadPool::shared()) : pool(pool) {}
+    
+    // Guess the format from the file extension
+    static Format formatForPath(const std::string& path) {
+        size_t dot = path.rfind('.');
+        std::string ext = dot == std::string::npos ? "" : path.substr(dot + 1);
+        return ext == "json" || ext == "jsonl" ? Format::JSON : Format::CSV;
+    }
+    
+    // Stream a file and call sink(record) for every valid player, in file order
+    template <typename Sink>
+    Result importFile(const std::string& path, Sink sink) {
+        Result result;
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            result.error = "cannot open " + path;
+            return result;
+        }
+        Format format = formatForPath(path);
+        
+        std::vector<int> columns;
+        std::string buffer;
+        std::vector<std::string_view> records;
+        std::vector<Record> parsed;
+        std::vector<char> valid;
+        bool finished = false;
+        
+        while (!finished) {
+            size_t kept = buffer.size();
+            buffer.resize(kept + CHUNK_BYTES);
+            file.read(&buffer[kept], CHUNK_BYTES);
+            buffer.resize(kept + static_cast<size_t>(file.gcount()));
+            finished = !file;
+            
+            records.clear();
+            size_t consumed = splitRecords(buffer, format, finished, records);
+            
+            size_t first = 0;
+            if (format == Format::CSV && columns.empty() && !records.empty()) {
+                // Header row defines the column mapping
+                std::string_view header = records[0];
+                size_t pos = 0;
+                while (pos != std::string_view::npos) {
+                    size_t end = header.find(',', pos);
+                    std::string_view name = trim(header.substr(pos, end == std::string_view::npos ? end : end - pos));
+                    if (!name.empty() && name.front() == '"') name = name.substr(1, name.size() - 2);
+                    columns.push_back(fieldForName(name));
+                    pos = end == std::string_view::npos ? end : end + 1;
+                }
+                if (std::find(columns.begin(), columns.end(), FIELD_ID) == columns.end() ||
+                    std::find(columns.begin(), columns.end(), FIELD_NAME) == columns.end() ||
+                    std::find(columns.begin(), columns.end(), FIELD_POSITION) == columns.end()) {
+                    result.error = "CSV header must include id, name and position columns";
+                    return result;
+                }
+                first = 1;
+            }
+            
+            size_t count = records.size() - first;
+            parsed.resize(count);
+            valid.assign(count, 0);
+            pool.parallelFor(count, RECORDS_PER_TASK, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    valid[i] = format == Format::CSV ? parseCsvRecord(records[first + i], columns, parsed[i])
+                                                     : parseJsonRecord(records[first + i], parsed[i]);
+                }
+            });
+            
+            for (size_t i = 0; i < count; ++i) {
+                if (valid[i] && sink(parsed[i])) {
+                    result.imported++;
+                } else {
+                    result.skipped++;
+                }
+            }
+            
+            buffer.erase(0, consumed);
+        }
+        return result;
+    }
+};
+
+// Index entry for a player: the object, the team that owns it (nullptr while available)
+// and its slot in the available pool
+struct PlayerHandle {
+    Player* player;
+    Team* owner;
+    uint32_t poolSlot;
+    
+    PlayerHandle() : player(nullptr), owner(nullptr), poolSlot(0) {}
+    PlayerHandle(Player* player, Team* owner) : player(player), owner(owner), poolSlot(0) {}
+};
+
+// Undrafted players, bucketed by position. Removal leaves a tombstone (O(1)) and a bucket
+// is compacted in order once tombstones outnumber live entries, so listings keep their
+// order and filtering by position only touches that position's players.
+class PlayerPool {
+private:
+    struct Bucket {
+        std::vector<Player*> slots;    // nullptr marks a removed player
+        size_t live;
+        
+        Bucket() : live(0) {}
+    };
+    
+    Bucket buckets[POSITION_COUNT];
+    size_t total;
+
+public:
+    PlayerPool() : total(0) {}
+    
+    size_t size() const { return total; }
+    size_t size(Position pos) const { return buckets[static_cast<int>(pos)].live; }
+    bool empty() const { return total == 0; }
+    
+    // Add a player; returns its slot within the position bucket
+    uint32_t add(Player* player) {
+        Bucket& bucket = buckets[static_cast<int>(player->getPosition())];
+        bucket.slots.push_back(player);
+        bucket.live++;
+        total++;
+        return static_cast<uint32_t>(bucket.slots.size() - 1);
+    }
+    
+    // Remove the player at a slot. If the bucket is compacted, onMove(player, newSlot)
+    // is called for every player whose slot changed.
+    template <typename OnMove>
+    void remove(Player* player, uint32_t slot, OnMove onMove) {
+        Bucket& bucket = buckets[static_cast<int>(player->getPosition())];
+        bucket.slots[slot] = nullptr;
+        bucket.live--;
+        total--;
+        
+        if (bucket.slots.size() - bucket.live > std::max<size_t>(bucket.live, 32)) {
+            size_t next = 0;
+            for (size_t i = 0; i < bucket.slots.size(); ++i) {
+                if (bucket.slots[i]) {
+                    if (next != i) {
+                        bucket.slots[next] = bucket.slots[i];
+                        onMove(bucket.slots[next], static_cast<uint32_t>(next));
+                    }
+                    next++;
+                }
+            }
+            bucket.slots.resize(next);
+        }
+    }
+    
+    // Visit the available players at one position, in pool order
+    template <typename Fn>
+    void forEach(Position pos, Fn fn) const {
+        for (Player* player : buckets[static_cast<int>(pos)].slots) {
+            if (player) {
+                fn(player);
+            }
+        }
+    }
+    
+    // Visit every available player, grouped by position
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int p = 0; p < POSITION_COUNT; ++p) {
+            forEach(static_cast<Position>(p), fn);
+        }
+    }
+};
+
+// League class to manage teams, players, and matchups
+class League {
+private:
+    // Storage for every object the league creates; released in bulk with the league
+    ObjectPool<Player> playerStore;
+    ObjectPool<Team, 64> teamStore;
+    ObjectPool<Matchup, 64> matchupStore;
+    
+    std::string name;
+    std::vector<Team*> teams;
+    std::unordered_map<std::string, Team*> teamsByName;
+    Standings standings;
+    StringInterner teamNames;
+    int maxPlayerId;
+    PlayerPool availablePlayers;
+    IdMap<PlayerHandle> playerIndex;
+    std::vector<Matchup*> schedule;
+    StatHistory history;
+    int currentWeek;
+    int maxTeams;
+    int rosterSize;
+    int lineupSize;
+    uint64_t seed;
+    bool hasSeed;
+    int seasonWeeks;
+    int playoffTeams;
+    std::ostream* messages;    // where status messages from mutations go
+    std::vector<LineupSlot> lineupSlots;   // positions the lineup optimizer must fill
+    ScoringRules scoringRules;              // teams score their games through this
+    mutable SeasonSchedule season;          // planned on first use, see seasonSchedule()
+    mutable bool scheduleStale;
+    uint32_t scheduleSeed;                  // plans the season when the league has no seed
+    int divisionCount;
+    int divisionWeeks;
+    
+    // Pending waiver claims, settled together by processWaivers
+    struct WaiverClaim {
+        Team* team;
+        int playerId;
+        int dropId;
+    };
+    std::vector<WaiverClaim> waiverClaims;
+    std::vector<Team*> waiverOrder;
+    
+    // Write-ahead journal: a snapshot at journalPath plus a log of the mutations since
+    std::unique_ptr<TransactionLog> journal;
+    std::string journalPath;
+    int mutationDepth;
+    
+    // Tracks nested mutations so only the outermost one is logged (a waiver run replays
+    // its own signings), and compacts the journal once that one has finished
+    struct Mutation {
+        League& league;
+        
+        explicit Mutation(League& league) : league(league) { league.mutationDepth++; }
+        
+        ~Mutation() {
+            if (--league.mutationDepth == 0 && league.journal && league.journal->size() >= CHECKPOINT_BYTES) {
+                league.compact();
+            }
+        }
+        
+        bool logged() const { return league.journal && league.mutationDepth == 1; }
+        
+        void log(TransactionLog::Op op, const TransactionLog::Record& record = TransactionLog::Record()) {
+            // Dropped by a failure earlier in this mutation
+            if (league.journal && !league.journal->append(op, record)) {
+                league.dropJournal();
+            }
+        }
+    };
+    
+    // Matchups per pool task in simulateWeek; smaller weeks are played on the calling thread
+    static const size_t MATCHUPS_PER_TASK = 64;
+    // Teams per pool task when optimizing every lineup
+    static const size_t TEAMS_PER_TASK = 64;
+    // deriveSeed stream for the season schedule (matchup streams use week << 32 | index)
+    static const uint64_t SCHEDULE_STREAM = ~0ULL;
+    // Log size that triggers a checkpoint
+    static const uint64_t CHECKPOINT_BYTES = 4 << 20;
+    
+    // Scoring rules as set (not compiled), for the journal
+    static TransactionLog::Record scoringRecord(const ScoringRules& rules) {
+        TransactionLog::Record record;
+        record.add(rules.getName());
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            record.add(rules.getBaseWeight(static_cast<Stat>(s)));
+            for (int p = 0; p < POSITION_COUNT; ++p) {
+                record.add(rules.getOverride(static_cast<Stat>(s), static_cast<Position>(p)));
+            }
+        }
+        record.add(static_cast<int32_t>(rules.getTiers().size()));
+        for (const ScoringRules::Tier& tier : rules.getTiers()) {
+            record.add(static_cast<int32_t>(tier.maxAllowed)).add(tier.bonus);
+        }
+        return record.add(rules.getWorstBonus());
+    }
+    
+    static ScoringRules readScoring(TransactionLog::Reader& in) {
+        ScoringRules rules;
+        rules.setName(in.readString());
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            rules.setWeight(static_cast<Stat>(s), in.readDouble());
+            for (int p = 0; p < POSITION_COUNT; ++p) {
+                double weight = in.readDouble();
+                if (!std::isnan(weight)) {
+                    rules.setWeight(static_cast<Stat>(s), static_cast<Position>(p), weight);
+                }
+            }
+        }
+        std::vector<ScoringRules::Tier> tiers(std::max(0, in.readInt()));
+        for (auto& tier : tiers) {
+            tier.maxAllowed = in.readInt();
+            tier.bonus = in.readDouble();
+        }
+        rules.setPointsAllowedTiers(tiers, in.readDouble());
+        return rules;
+    }
+    
+    // Redo one logged mutation; false if the record is damaged or no longer applies
+    bool replay(TransactionLog::Op op, TransactionLog::Reader& in) {
+        using Op = TransactionLog::Op;
+        switch (op) {
+            case Op::REGISTER_TEAM: {
+                std::string teamName = in.readString();
+                std::string ownerName = in.readString();
+                return in.ok() && registerTeam(teamName, ownerName);
+            }
+            case Op::DRAFT:
+            case Op::DROP: {
+                Team* team = getTeamByName(in.readString());
+                int playerId = in.readInt();
+                return in.ok() && team && (op == Op::DRAFT ? draftPlayer(team, playerId) : dropPlayer(team, playerId));
+            }
+            case Op::ADD:
+            case Op::CLAIM: {
+                Team* team = getTeamByName(in.readString());
+                int playerId = in.readInt();
+                int dropId = in.readInt();
+                return in.ok() && team && (op == Op::ADD ? addFreeAgent(team, playerId, dropId)
+                                                         : submitWaiverClaim(team, playerId, dropId));
+            }
+            case Op::PROCESS_WAIVERS:
+                processWaivers();
+                return true;
+            case Op::TRADE: {
+                Team* first = getTeamByName(in.readString());
+                std::vector<int> firstGives = in.readIds();
+                Team* second = getTeamByName(in.readString());
+                std::vector<int> secondGives = in.readIds();
+                return in.ok() && first && second && tradePlayers(first, firstGives, second, secondGives);
+            }
+            case Op::LINEUP: {
+                Team* team = getTeamByName(in.readString());
+                std::vector<int> ids = in.readIds();
+                return in.ok() && team && setTeamLineup(team, ids);
+            }
+            case Op::GENERATE_MATCHUPS:
+                return generateMatchups();
+            case Op::SIMULATE_WEEK: {
+                size_t count = static_cast<size_t>(std::max(0, in.readInt()));
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t matchupSeed = in.readU64();
+                    if (count == schedule.size()) {
+                        schedule[i]->setSeed(matchupSeed);
+                    }
+                }
+                return in.ok() && count == schedule.size() && simulateWeek();
+            }
+            case Op::SEED: {
+                uint64_t value = in.readU64();
+                if (in.ok()) {
+                    setSeed(value);
+                }
+                return in.ok();
+            }
+            case Op::SEASON_FORMAT:
+            case Op::DIVISION_FORMAT: {
+                int first = in.readInt();
+                int second = in.readInt();
+                if (in.ok()) {
+                    op == Op::SEASON_FORMAT ? setSeasonFormat(first, second) : setDivisionFormat(first, second);
+                }
+                return in.ok();
+            }
+            case Op::SCORING: {
+                ScoringRules rules = readScoring(in);
+                if (in.ok()) {
+                    setScoringRules(rules);
+                }
+                return in.ok();
+            }
+            case Op::WAIVER_ORDER: {
+                std::vector<Team*> order(std::max(0, in.readInt()));
+                for (auto& team : order) {
+                    team = getTeamByName(in.readString());
+                }
+                if (!in.ok() || std::count(order.begin(), order.end(), nullptr)) {
+                    return false;
+                }
+                waiverOrder = order;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Play the unplayed matchups of schedule[begin, end) as one LineupBatch, setting
+    // played[i] for each that had both lineups. The batch's buffers are per thread, so they
+    // stay warm across the tasks and leagues a thread plays in turn.
+    void playMatchups(size_t begin, size_t end, std::vector<char>& played) {
+        static thread_local LineupBatch batch;
+        batch.clear();
+        {
+            Trace::Scope trace("matchupBatch:play");
+            for (size_t i = begin; i < end; ++i) {
+                const Matchup& matchup = *schedule[i];
+                played[i] = !matchup.getIsCompleted() && matchup.getHomeTeam()->getLineupSize() > 0
+                    && matchup.getAwayTeam()->getLineupSize() > 0;
+                if (played[i]) {
+                    batch.beginGame(matchup.getSeed());
+                    batch.addLineup(matchup.getHomeTeam()->getActiveLineup());
+                    batch.addLineup(matchup.getAwayTeam()->getActiveLineup());
+                }
+            }
+            batch.simulate(scoringRules);
+            
+            size_t lineup = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (played[i]) {
+                    schedule[i]->setScores(batch.score(lineup), batch.score(lineup + 1));
+                    lineup += 2;
+                }
+            }
+        }
+        {
+            Trace::Scope trace("matchupBatch:record");
+            batch.recordGames();
+        }
+        batch.clear();
+    }
+
+public:
+    League(const std::string& name, int maxTeams, int rosterSize, int lineupSize, bool loadDefaultPlayers = true)
+        : name(name), maxPlayerId(0), currentWeek(1), maxTeams(maxTeams), rosterSize(rosterSize), lineupSize(lineupSize),
+          seed(0), hasSeed(false), seasonWeeks(14), playoffTeams(4), messages(&std::cout),
+          lineupSlots(LineupSlots::standard(lineupSize)), scheduleStale(true),
+          scheduleSeed(static_cast<uint32_t>(Random::engine()())), divisionCount(1), divisionWeeks(0),
+          mutationDepth(0) {
+        // Initialize available players with hard-coded data
+        if (loadDefaultPlayers) {
+            initializePlayers();
+        }
+    }
+    
+    // Write the full league state to a binary snapshot file (written to a temporary
+    // file first, then renamed, so an existing snapshot is never left half-written)
+    bool saveSnapshot(const std::string& path) const {
+        std::string longName = unsavableName();
+        if (!longName.empty()) {
+            *messages << "Cannot save \"" << longName << "\": a snapshot holds names of at most "
+                      << Snapshot::NAME_LENGTH - 1 << " bytes.\n";
+            return false;
+        }
+        return Snapshot::writeFile(path, snapshotImage());
+    }
+    
+    // The first name a snapshot would truncate (league, team, owner, player or player team),
+    // or "" if they all fit. Saving one would lose data or, for a team name, break the load.
+    std::string unsavableName() const {
+        std::string found;
+        auto check = [&found](const std::string& value) {
+            if (found.empty() && !Snapshot::fitsName(value)) {
+                found = value;
+            }
+        };
+        auto checkPlayer = [&check](const Player* player) {
+            check(player->getName());
+            check(player->getTeam());
+        };
+        check(name);
+        availablePlayers.forEach(checkPlayer);
+        for (const Team* team : teams) {
+            check(team->getName());
+            check(team->getOwner());
+            for (const auto& player : team->getRoster()) {
+                checkPlayer(player);
+            }
+        }
+        return found;
+    }
+    
+    // The full league state in snapshot layout; see unsavableName for what it cannot hold
+    std::string snapshotImage() const {
+        std::unordered_map<const Team*, int32_t> teamIndex;
+        for (size_t i = 0; i < teams.size(); ++i) {
+            teamIndex[teams[i]] = static_cast<int32_t>(i);
+        }
+        
+        // Player records are the bulk of the image, so they are written in place into the
+        // zero-filled image (which also zeroes unused stat slots and name padding)
+        size_t playerCount = availablePlayers.size();
+        for (const Team* team : teams) {
+            playerCount += team->getRoster().size();
+        }
+        std::string image(sizeof(Snapshot::Header) + playerCount * sizeof(Snapshot::PlayerRecord), '\0');
+        size_t playerEnd = sizeof(Snapshot::Header);
+        auto addPlayer = [&image, &playerEnd](const Player* player, int32_t owner) {
+            Snapshot::PlayerRecord& record = *reinterpret_cast<Snapshot::PlayerRecord*>(&image[playerEnd]);
+            record.id = player->getId();
+            record.position = static_cast<int32_t>(player->getPosition());
+            record.owner = owner;
+            record.gamesPlayed = player->getGamesPlayed();
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                record.stats[s] = player->getStats()[s];
+            }
+            record.fantasyPoints = player->getFantasyPoints();
+            record.historyGames = player->getHistoryGames();
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                record.history[s] = player->getHistoryStats()[s];
+            }
+            std::memcpy(record.name, player->getName().data(), std::min(player->getName().size(), Snapshot::NAME_LENGTH - 1));
+            std::memcpy(record.team, player->getTeam().data(), std::min(player->getTeam().size(), Snapshot::NAME_LENGTH - 1));
+            playerEnd += sizeof(record);
+        };
+        availablePlayers.forEach([&addPlayer](const Player* player) { addPlayer(player, -1); });
+        
+        std::vector<Snapshot::TeamRecord> teamRecords;
+        std::vector<int32_t> members;
+        for (size_t i = 0; i < teams.size(); ++i) {
+            const Team* team = teams[i];
+            Snapshot::TeamRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.wins = team->getWins();
+            record.losses = team->getLosses();
+            record.totalPoints = team->getTotalPoints();
+            record.rosterStart = static_cast<uint32_t>(members.size());
+            record.rosterCount = static_cast<uint32_t>(team->getRoster().size());
+            for (const auto& player : team->getRoster()) {
+                members.push_back(player->getId());
+                addPlayer(player, static_cast<int32_t>(i));
+            }
+            record.lineupStart = static_cast<uint32_t>(members.size());
+            record.lineupCount = static_cast<uint32_t>(team->getActiveLineup().size());
+            for (const auto& player : team->getActiveLineup()) {
+                members.push_back(player->getId());
+            }
+            Snapshot::copyName(record.name, team->getName());
+            Snapshot::copyName(record.owner, team->getOwner());
+            teamRecords.push_back(record);
+        }
+        
+        std::vector<Snapshot::MatchupRecord> matchups;
+        for (const auto& matchup : schedule) {
+            Snapshot::MatchupRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.home = teamIndex[matchup->getHomeTeam()];
+            record.away = teamIndex[matchup->getAwayTeam()];
+            record.homeScore = matchup->getHomeScore();
+            record.awayScore = matchup->getAwayScore();
+            record.seed = matchup->getSeed();
+            record.hasSeed = matchup->isSeeded();
+            record.completed = matchup->getIsCompleted();
+            matchups.push_back(record);
+        }
+        
+        Snapshot::Header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = Snapshot::MAGIC;
+        header.version = Snapshot::VERSION;
+        header.playerCount = static_cast<uint32_t>(playerCount);
+        header.teamCount = static_cast<uint32_t>(teamRecords.size());
+        header.memberCount = static_cast<uint32_t>(members.size());
+        header.matchupCount = static_cast<uint32_t>(matchups.size());
+        header.currentWeek = currentWeek;
+        header.maxTeams = maxTeams;
+        header.rosterSize = rosterSize;
+        header.lineupSize = lineupSize;
+        header.seasonWeeks = seasonWeeks;
+        header.playoffTeams = playoffTeams;
+        header.seed = seed;
+        header.hasSeed = hasSeed;
+        header.scheduleSeed = scheduleSeed;
+        header.divisionCount = divisionCount;
+        header.divisionWeeks = divisionWeeks;
+        Snapshot::copyName(header.leagueName, name);
+        
+        std::memcpy(&image[0], &header, sizeof(header));
+        image.reserve(image.size() + teamRecords.size() * sizeof(Snapshot::TeamRecord)
+                      + members.size() * sizeof(int32_t) + matchups.size() * sizeof(Snapshot::MatchupRecord));
+        auto append = [&image](const void* data, size_t bytes) {
+            image.append(static_cast<const char*>(data), bytes);
+        };
+        append(teamRecords.data(), teamRecords.size() * sizeof(Snapshot::TeamRecord));
+        append(members.data(), members.size() * sizeof(int32_t));
+        append(matchups.data(), matchups.size() * sizeof(Snapshot::MatchupRecord));
+        return image;
+    }
+    
+    // Rebuild a league from a mapped snapshot. Returns nullptr if the snapshot is invalid.
+    static League* fromSnapshot(const MappedSnapshot& snapshot) {
+        if (!snapshot.isValid()) {
+            return nullptr;
+        }
+        
+        const Snapshot::Header& header = snapshot.header();
+        League* league = new League(Snapshot::readName(header.leagueName), header.maxTeams,
+                                    header.rosterSize, header.lineupSize, false);
+        league->currentWeek = header.currentWeek;
+        league->seasonWeeks = header.seasonWeeks;
+        league->playoffTeams = header.playoffTeams;
+        league->seed = header.seed;
+        league->hasSeed = header.hasSeed != 0;
+        league->scheduleSeed = header.scheduleSeed;
+        league->divisionCount = header.divisionCount;
+        league->divisionWeeks = header.divisionWeeks;
+        
+        const Snapshot::TeamRecord* teamRecords = snapshot.teams();
+        for (uint32_t i = 0; i < header.teamCount; ++i) {
+            Team* team = league->teamStore.create(Snapshot::readName(teamRecords[i].name),
+                                                  Snapshot::readName(teamRecords[i].owner));
+            team->attachStandings(&league->standings);
+            team->setScoringRules(&league->scoringRules);
+            team->restoreRecord(teamRecords[i].wins, teamRecords[i].losses, teamRecords[i].totalPoints);
+            league->teams.push_back(team);
+            league->teamsByName[team->getName()] = team;
+        }
+        
+        league->playerIndex.reserve(header.playerCount);
+        const Snapshot::PlayerRecord* players = snapshot.players();
+        for (uint32_t i = 0; i < header.playerCount; ++i) {
+            const Snapshot::PlayerRecord& record = players[i];
+            StatLine stats{}, history{};
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                stats[s] = record.stats[s];
+                history[s] = record.history[s];
+            }
+            Position position = static_cast<Position>(record.position);
+            Player* player;
+            if (record.owner < 0) {
+                player = league->addAvailablePlayer(record.id, Snapshot::readName(record.name), position,
+                                                    Snapshot::readName(record.team));
+            } else {
+                player = league->playerStore.create(record.id, Snapshot::readName(record.name), position,
+                                                    league->teamNames.intern(Snapshot::readName(record.team)));
+                league->maxPlayerId = std::max(league->maxPlayerId, static_cast<int>(record.id));
+                league->playerIndex.insert(record.id, PlayerHandle(player, league->teams[record.owner]));
+            }
+            player->restoreStats(record.gamesPlayed, stats, record.fantasyPoints);
+            if (record.historyGames > 0) {
+                player->fitModel(record.historyGames, history);
+            }
+            league->history.track(player);
+        }
+        
+        const int32_t* members = snapshot.members();
+        for (uint32_t i = 0; i < header.teamCount; ++i) {
+            Team* team = league->teams[i];
+            for (uint32_t m = 0; m < teamRecords[i].rosterCount; ++m) {
+                team->addPlayer(league->playerIndex.find(members[teamRecords[i].rosterStart + m])->player);
+            }
+            std::vector<int> lineup(members + teamRecords[i].lineupStart,
+                                    members + teamRecords[i].lineupStart + teamRecords[i].lineupCount);
+            team->setLineup(lineup);
+        }
+        
+        const Snapshot::MatchupRecord* matchups = snapshot.matchups();
+        for (uint32_t i = 0; i < header.matchupCount; ++i) {
+            Matchup* matchup = league->matchupStore.create(league->teams[matchups[i].home], league->teams[matchups[i].away]);
+            if (matchups[i].hasSeed) {
+                matchup->setSeed(matchups[i].seed);
+            }
+            matchup->restoreResult(matchups[i].homeScore, matchups[i].awayScore, matchups[i].completed != 0);
+            league->schedule.push_back(matchup);
+        }
+        
+        return league;
+    }
+    
+    // Keep a write-ahead journal at path: a snapshot of the league now, then a log of
+    // every mutation after it (in path + ".log"). Returns false if neither can be written.
+    bool startJournal(const std::string& path) {
+        journalPath = path;
+        if (!checkpoint()) {
+            journalPath.clear();
+            return false;
+        }
+        return true;
+    }
+    
+    // Stop logging; the files stay behind and can still be recovered
+    void stopJournal() {
+        journal.reset();
+        journalPath.clear();
+    }
+    
+    bool isJournaled() const { return journal != nullptr; }
+    
+    // Wait until every logged mutation is on disk. If a write failed, the journal is
+    // dropped (with a message) and false is returned.
+    bool syncJournal() {
+        if (journal && !journal->sync()) {
+            dropJournal();
+            return false;
+        }
+        return true;
+    }
+    
+    // Compact the journal and wait until the new snapshot and log are on disk
+    bool checkpoint() {
+        if (journalPath.empty()) {
+            return false;
+        }
+        compact();
+        return syncJournal() && isJournaled();
+    }
+    
+    // Start an empty log on top of a snapshot of the league now. Only the snapshot image is
+    // built here; the old log's flusher closes it, then writes the image and switches to
+    // the new log in the background, so a mutation that triggers this does not wait for the
+    // disk. Settings the snapshot cannot hold (scoring rules, waivers) open the new log.
+    void compact() {
+        std::string longName = unsavableName();
+        if (!longName.empty()) {
+            *messages << "Cannot snapshot \"" << longName << "\" (names hold at most " << Snapshot::NAME_LENGTH - 1
+                      << " bytes); the league is no longer journaled.\n";
+            journal.reset();
+            journalPath.clear();
+            return;
+        }
+        journal = TransactionLog::start(journalPath + ".log", journalPath, snapshotImage(), std::move(journal));
+        journal->append(TransactionLog::Op::SCORING, scoringRecord(scoringRules));
+        if (!waiverOrder.empty()) {
+            TransactionLog::Record order;
+            order.add(static_cast<int32_t>(waiverOrder.size()));
+            for (const Team* team : waiverOrder) {
+                order.add(team->getName());
+            }
+            journal->append(TransactionLog::Op::WAIVER_ORDER, order);
+        }
+        for (const WaiverClaim& claim : waiverClaims) {
+            journal->append(TransactionLog::Op::CLAIM, TransactionLog::Record().add(claim.team->getName())
+                                                           .add(claim.playerId).add(claim.dropId));
+        }
+    }
+    
+    // A journal write failed: stop logging rather than pretend mutations are durable
+    void dropJournal() {
+        *messages << "Cannot write the journal at " << journalPath << "; the league is no longer journaled.\n";
+        journal.reset();
+        journalPath.clear();
+    }
+    
+    // Rebuild a journaled league: the snapshot at path with every intact record of its log
+    // replayed. A log older than the snapshot (a crash in the middle of a checkpoint) only
+    // contributes its settings; the rest of it is already in the snapshot. Returns nullptr,
+    // with the reason in error, if the snapshot cannot be loaded or a logged mutation no
+    // longer applies. The league is not journaled until startJournal.
+    static League* recover(const std::string& path, std::string& error, size_t& replayed) {
+        MappedSnapshot snapshot(path);
+        League* league = fromSnapshot(snapshot);
+        if (!league) {
+            error = snapshot.getError();
+            return nullptr;
+        }
+        
+        // Every record was acknowledged once, so one that no longer applies means the
+        // league would silently lose it: fail the recovery instead
+        std::ostringstream log;
+        league->setMessageStream(log);
+        uint64_t expected = snapshot.digest();
+        uint64_t digest = 0;
+        size_t index = 0;
+        replayed = 0;
+        error.clear();
+        TransactionLog::replay(path + ".log", digest, [&](TransactionLog::Op op, TransactionLog::Reader& in) {
+            if (!error.empty() || (digest != expected && !TransactionLog::isSetting(op))) {
+                return;
+            }
+            index++;
+            log.str(std::string());
+            if (league->replay(op, in)) {
+                replayed++;
+            } else if (!TransactionLog::isSetting(op)) {
+                std::string reason = log.str();
+                while (!reason.empty() && reason.back() == '\n') {
+                    reason.pop_back();
+                }
+                error = "journal record " + std::to_string(index) + " does not apply"
+                      + (reason.empty() ? std::string() : " (" + reason.substr(reason.rfind('\n') + 1) + ")");
+            }
+        });
+        league->setMessageStream(std::cout);
+        if (!error.empty()) {
+            delete league;
+            return nullptr;
+        }
+        return league;
+    }
+    
+    // Seed the league so pairings and every matchup replay identically.
+    // Each week and matchup draws from its own stream derived from this seed.
+    void setSeed(uint64_t value) {
+        Mutation mutation(*this);
+        seed = value;
+        hasSeed = true;
+        scheduleStale = true;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::SEED, TransactionLog::Record().add(value));
+        }
+    }
+    
+    // Redirect status messages (e.g. to a buffer or a null stream in batch mode)
+    void setMessageStream(std::ostream& out) {
+        messages = &out;
+    }
+    
+    // Regular season length and playoff field used for season odds
+    void setSeasonFormat(int weeks, int playoffSpots) {
+        Mutation mutation(*this);
+        seasonWeeks = weeks;
+        playoffTeams = playoffSpots;
+        scheduleStale = true;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::SEASON_FORMAT, TransactionLog::Record().add(weeks).add(playoffSpots));
+        }
+    }
+    
+    // Split teams into divisions (by registration order, round robin) and play `weeks` of
+    // the season within them
+    void setDivisionFormat(int divisions, int weeks) {
+        Mutation mutation(*this);
+        divisionCount = std::max(1, divisions);
+        divisionWeeks = std::max(0, weeks);
+        scheduleStale = true;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::DIVISION_FORMAT, TransactionLog::Record().add(divisionCount).add(divisionWeeks));
+        }
+    }
+    
+    // The regular season for the current teams and format. Planning a new one (after teams
+    // or the format change) keeps the weeks already played and re-pairs the rest.
+    const SeasonSchedule& seasonSchedule() const {
+        if (scheduleStale) {
+            std::vector<int> division;
+            if (divisionCount > 1) {
+                for (size_t t = 0; t < teams.size(); ++t) {
+                    division.push_back(static_cast<int>(t) % divisionCount);
+                }
+            }
+            uint64_t planSeed = hasSeed ? Random::deriveSeed(seed, SCHEDULE_STREAM) : scheduleSeed;
+            season = SeasonSchedule::build(static_cast<int>(teams.size()), seasonWeeks, planSeed,
+                                           division, divisionWeeks);
+            scheduleStale = false;
+        }
+        return season;
+    }
+    
+    // Copy what the season simulator needs: lineups, records so far and the remaining schedule
+    SeasonSnapshot seasonSnapshot() const {
+        SeasonSnapshot snapshot;
+        snapshot.playoffTeams = playoffTeams;
+        snapshot.scoring = scoringRules;
+        for (const auto& team : teams) {
+            snapshot.teamNames.push_back(team->getName());
+            std::vector<std::shared_ptr<const StatModel>> lineup;
+            for (const auto& player : team->getActiveLineup()) {
+                lineup.push_back(player->shareModel());
+            }
+            snapshot.lineups.push_back(lineup);
+            snapshot.wins.push_back(team->getWins());
+            snapshot.points.push_back(team->getTotalPoints());
+        }
+        snapshot.schedule = seasonSchedule();
+        snapshot.firstWeek = currentWeek - 1;
+        return snapshot;
+    }
+    
+    // Create a player in the available pool and the ID index
+    Player* addAvailablePlayer(int id, const std::string& playerName, Position position, const std::string& team) {
+        Player* player = playerStore.create(id, playerName, position, teamNames.intern(team));
+        maxPlayerId = std::max(maxPlayerId, id);
+        PlayerHandle handle(player, nullptr);
+        handle.poolSlot = availablePlayers.add(player);
+        playerIndex.insert(player->getId(), handle);
+        history.track(player);
+        return player;
+    }
+    
+    // Take a player out of the available pool, keeping pool slots in the index current
+    void removeAvailablePlayer(PlayerHandle& handle) {
+        availablePlayers.remove(handle.player, handle.poolSlot, [this](Player* moved, uint32_t slot) {
+            playerIndex.find(moved->getId())->poolSlot = slot;
+        });
+    }
+    
+    // Add players from a CSV or JSON file to the available pool. Rows with an ID that is
+    // already in the league are skipped; rows with games played also fit the player's stat
+    // model to that history.
+    PlayerImporter::Result importPlayers(const std::string& path) {
+        PlayerImporter importer;
+        return importer.importFile(path, [this](const PlayerImporter::Record& record) {
+            if (playerIndex.contains(record.id)) {
+                return false;
+            }
+            Player* player = addAvailablePlayer(record.id, record.name, record.position, std::string(record.team));
+            if (record.gamesPlayed > 0 || record.hasFantasyPoints) {
+                double points = record.hasFantasyPoints ? record.fantasyPoints
+                                                        : scoringRules.scoreTotals(record.stats, record.position);
+                player->restoreStats(record.gamesPlayed, record.stats, points);
+                player->fitModel(record.gamesPlayed, record.stats);
+            }
+            return true;
+        });
+    }
+    
+    // Initialize players with hard-coded data
+    void initializePlayers() {
+        // Quarterbacks
+        addAvailablePlayer(1, "Patrick Mahomes", Position::QUARTERBACK, "Kansas City");
+        addAvailablePlayer(2, "Josh Allen", Position::QUARTERBACK, "Buffalo");
+        addAvailablePlayer(3, "Lamar Jackson", Position::QUARTERBACK, "Baltimore");
+        addAvailablePlayer(4, "Joe Burrow", Position::QUARTERBACK, "Cincinnati");
+        addAvailablePlayer(5, "Justin Herbert", Position::QUARTERBACK, "Los Angeles");
+        addAvailablePlayer(6, "Jalen Hurts", Position::QUARTERBACK, "Philadelphia");
+        
+        // Running Backs
+        addAvailablePlayer(7, "Christian McCaffrey", Position::RUNNING_BACK, "San Francisco");
+        addAvailablePlayer(8, "Derrick Henry", Position::RUNNING_BACK, "Tennessee");
+        addAvailablePlayer(9, "Jonathan Taylor", Position::RUNNING_BACK, "Indianapolis");
+        addAvailablePlayer(10, "Nick Chubb", Position::RUNNING_BACK, "Cleveland");
+        addAvailablePlayer(11, "Saquon Barkley", Position::RUNNING_BACK, "New York");
+        addAvailablePlayer(12, "Austin Ekeler", Position::RUNNING_BACK, "Los Angeles");
+        addAvailablePlayer(13, "Alvin Kamara", Position::RUNNING_BACK, "New Orleans");
+        addAvailablePlayer(14, "Dalvin Cook", Position::RUNNING_BACK, "Minnesota");
+        
+        // Wide Receivers
+        addAvailablePlayer(15, "Justin Jefferson", Position::WIDE_RECEIVER, "Minnesota");
+        addAvailablePlayer(16, "Tyreek Hill", Position::WIDE_RECEIVER, "Miami");
+        addAvailablePlayer(17, "Davante Adams", Position::WIDE_RECEIVER, "Las Vegas");
+        addAvailablePlayer(18, "Cooper Kupp", Position::WIDE_RECEIVER, "Los Angeles");
+        addAvailablePlayer(19, "Stefon Diggs", Position::WIDE_RECEIVER, "Buffalo");
+        addAvailablePlayer(20, "CeeDee Lamb", Position::WIDE_RECEIVER, "Dallas");
+        addAvailablePlayer(21, "A.J. Brown", Position::WIDE_RECEIVER, "Philadelphia");
+        addAvailablePlayer(22, "Ja'Marr Chase", Position::WIDE_RECEIVER, "Cincinnati");
+        addAvailablePlayer(23, "Deebo Samuel", Position::WIDE_RECEIVER, "San Francisco");
+        addAvailablePlayer(24, "Mike Evans", Position::WIDE_RECEIVER, "Tampa Bay");
+        
+        // Tight Ends
+        addAvailablePlayer(25, "Travis Kelce", Position::TIGHT_END, "Kansas City");
+        addAvailablePlayer(26, "Mark Andrews", Position::TIGHT_END, "Baltimore");
+        addAvailablePlayer(27, "George Kittle", Position::TIGHT_END, "San Francisco");
+        addAvailablePlayer(28, "T.J. Hockenson", Position::TIGHT_END, "Detroit");
+        addAvailablePlayer(29, "Dallas Goedert", Position::TIGHT_END, "Philadelphia");
+        
+        // Kickers
+        addAvailablePlayer(30, "Justin Tucker", Position::KICKER, "Baltimore");
+        addAvailablePlayer(31, "Harrison Butker", Position::KICKER, "Kansas City");
+        addAvailablePlayer(32, "Evan McPherson", Position::KICKER, "Cincinnati");
+        addAvailablePlayer(33, "Tyler Bass", Position::KICKER, "Buffalo");
+        
+        // Defenses
+        addAvailablePlayer(34, "San Francisco 49ers", Position::DEFENSE, "San Francisco");
+        addAvailablePlayer(35, "Dallas Cowboys", Position::DEFENSE, "Dallas");
+        addAvailablePlayer(36, "Buffalo Bills", Position::DEFENSE, "Buffalo");
+        addAvailablePlayer(37, "New England Patriots", Position::DEFENSE, "New England");
+        addAvailablePlayer(38, "Pittsburgh Steelers", Position::DEFENSE, "Pittsburgh");
+    }
+    
+    // Register a new team
+    bool registerTeam(const std::string& teamName, const std::string& ownerName) {
+        Mutation mutation(*this);
+        // Snapshots and the journal key on the full name, so it must survive a snapshot
+        if (!Snapshot::fitsName(teamName) || !Snapshot::fitsName(ownerName)) {
+            *messages << "Team and owner names can be at most " << Snapshot::NAME_LENGTH - 1 << " characters.\n";
+            return false;
+        }
+        if (teams.size() >= maxTeams) {
+            *messages << "Maximum number of teams reached.\n";
+            return false;
+        }
+        
+        // Check if team name is already taken
+        if (teamsByName.count(teamName)) {
+            *messages << "Team name already exists. Please choose another name.\n";
+            return false;
+        }
+        
+        Team* team = teamStore.create(teamName, ownerName);
+        team->attachStandings(&standings);
+        team->setScoringRules(&scoringRules);
+        teams.push_back(team);
+        teamsByName[teamName] = team;
+        scheduleStale = true;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::REGISTER_TEAM, TransactionLog::Record().add(teamName).add(ownerName));
+        }
+        *messages << "Team \"" << teamName << "\" successfully registered!\n";
+        return true;
+    }
+    
+    // Display all teams
+    void displayTeams(ReportWriter& report) const {
+        Trace::Scope trace("report:teams");
+        report.beginReport("TEAMS");
+        
+        if (teams.empty()) {
+            report.note("No teams registered yet.");
+        } else {
+            report.beginTable({}, {{"No.", 5, false}, {"Team", 20, false}, {"Owner", 20, false},
+                                   {"Record", 10, false}, {"Points", 10, false}});
+            for (size_t i = 0; i < teams.size(); ++i) {
+                report.cell(i + 1);
+                writeTeamCells(report, teams[i]);
+            }
+            report.endTable();
+        }
+        report.endReport();
+    }
+    
+    void displayTeams() const {
+        displayTeams(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Display available players
+    void displayAvailablePlayers(ReportWriter& report) const {
+        Trace::Scope trace("report:available");
+        report.beginReport("AVAILABLE PLAYERS");
+        
+        if (availablePlayers.empty()) {
+            report.note("No available players.");
+        } else {
+            report.beginTable({}, {{"ID", 4, false}, {"Name", 20, false}, {"Pos", 5, false}, {"Team", 15, false}});
+            availablePlayers.forEach([&report](const Player* player) {
+                report.cell(player->getId());
+                report.cell(player->getName());
+                report.cell(positionToString(player->getPosition()));
+                report.cell(player->getTeam());
+                report.endRow();
+            });
+            report.endTable();
+        }
+        report.endReport();
+    }
+    
+    void displayAvailablePlayers() const {
+        displayAvailablePlayers(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Display players by position
+    void displayPlayersByPosition(Position pos, ReportWriter& report) const {
+        Trace::Scope trace("report:position");
+        std::string posStr = positionToString(pos);
+        report.beginReport("AVAILABLE " + posStr + "s");
+        
+        report.beginTable({}, {{"ID", 4, false}, {"Name", 20, false}, {"Team", 15, false}});
+        availablePlayers.forEach(pos, [&report](const Player* player) {
+            report.cell(player->getId());
+            report.cell(player->getName());
+            report.cell(player->getTeam());
+            report.endRow();
+        });
+        report.endTable();
+        
+        if (availablePlayers.size(pos) == 0) {
+            report.note("No available players at position " + posStr + ".");
+        }
+        report.endReport();
+    }
+    
+    void displayPlayersByPosition(Position pos) const {
+        displayPlayersByPosition(pos, TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Draft a player to a team
+    bool draftPlayer(Team* team, int playerId) {
+        Mutation mutation(*this);
+        // Find the player in available players
+        PlayerHandle* handle = playerIndex.find(playerId);
+        if (!handle || handle->owner) {
+            *messages << "Player ID " << playerId << " not found in available players.\n";
+            return false;
+        }
+        
+        if (team->getRosterSize() >= rosterSize) {
+            *messages << "Team roster is full (" << rosterSize << " players maximum).\n";
+            return false;
+        }
+        
+        Player* player = handle->player;
+        
+        // Add player to team
+        if (team->addPlayer(player)) {
+            // Remove from available players
+            removeAvailablePlayer(*handle);
+            handle->owner = team;
+            if (mutation.logged()) {
+                mutation.log(TransactionLog::Op::DRAFT, TransactionLog::Record().add(team->getName()).add(playerId));
+            }
+            *messages << player->getName() << " has been drafted to " << team->getName() << "!\n";
+            return true;
+        } else {
+            *messages << "Player is already on the team roster.\n";
+            return false;
+        }
+    }
+    
+    // Release a player from a team back into the available pool
+    bool dropPlayer(Team* team, int playerId) {
+        Mutation mutation(*this);
+        PlayerHandle* handle = playerIndex.find(playerId);
+        if (!handle || handle->owner != team || !team->removePlayer(playerId)) {
+            *messages << "Player ID " << playerId << " is not on " << team->getName() << "'s roster.\n";
+            return false;
+        }
+        
+        handle->owner = nullptr;
+        handle->poolSlot = availablePlayers.add(handle->player);
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::DROP, TransactionLog::Record().add(team->getName()).add(playerId));
+        }
+        *messages << handle->player->getName() << " has been released by " << team->getName() << ".\n";
+        return true;
+    }
+    
+    // Sign an available player straight away, first releasing dropId (0 for none) if given
+    bool addFreeAgent(Team* team, int playerId, int dropId = 0) {
+        Mutation mutation(*this);
+        PlayerHandle* handle = playerIndex.find(playerId);
+        if (!handle || handle->owner) {
+            *messages << "Player ID " << playerId << " is not a free agent.\n";
+            return false;
+        }
+        if (dropId != 0) {
+            const PlayerHandle* dropped = playerIndex.find(dropId);
+            if (!dropped || dropped->owner != team) {
+                *messages << "Player ID " << dropId << " is not on " << team->getName() << "'s roster.\n";
+                return false;
+            }
+        } else if (team->getRosterSize() >= rosterSize) {
+            *messages << "Team roster is full (" << rosterSize << " players maximum).\n";
+            return false;
+        }
+        
+        if (dropId != 0) {
+            dropPlayer(team, dropId);
+        }
+        Player* player = handle->player;
+        team->addPlayer(player);
+        removeAvailablePlayer(*handle);
+        handle->owner = team;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::ADD, TransactionLog::Record().add(team->getName()).add(playerId).add(dropId));
+        }
+        *messages << player->getName() << " has been signed by " << team->getName() << ".\n";
+        return true;
+    }
+    
+    // Queue a claim for an available player; claims are settled by processWaivers
+    bool submitWaiverClaim(Team* team, int playerId, int dropId = 0) {
+        Mutation mutation(*this);
+        const PlayerHandle* handle = playerIndex.find(playerId);
+        if (!handle || handle->owner) {
+            *messages << "Player ID " << playerId << " is not a free agent.\n";
+            return false;
+        }
+        waiverClaims.push_back({team, playerId, dropId});
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::CLAIM, TransactionLog::Record().add(team->getName()).add(playerId).add(dropId));
+        }
+        *messages << team->getName() << " put in a claim for " << handle->player->getName() << ".\n";
+        return true;
+    }
+    
+    // Teams in waiver priority order, best first. Priority starts as reverse standings
+    // and rolls: a team that is awarded a claim drops to the back.
+    const std::vector<Team*>& getWaiverOrder() {
+        if (waiverOrder.size() != teams.size()) {
+            std::unordered_set<const Team*> placed(waiverOrder.begin(), waiverOrder.end());
+            for (size_t i = standings.size(); i-- > 0;) {
+                if (!placed.count(standings.at(i))) {
+                    waiverOrder.push_back(standings.at(i));
+                }
+            }
+        }
+        return waiverOrder;
+    }
+    
+    // Settle queued claims. The team with the best priority that still has a claim gets
+    // its earliest claim that can be filled; claims that can no longer be filled are
+    // dropped. Returns the number of claims awarded.
+    size_t processWaivers() {
+        Mutation mutation(*this);
+        getWaiverOrder();
+        size_t awarded = 0;
+        bool progress = true;
+        while (progress && !waiverClaims.empty()) {
+            progress = false;
+            for (size_t rank = 0; rank < waiverOrder.size() && !progress; ++rank) {
+                Team* team = waiverOrder[rank];
+                for (size_t c = 0; c < waiverClaims.size();) {
+                    if (waiverClaims[c].team != team) {
+                        ++c;
+                        continue;
+                    }
+                    WaiverClaim claim = waiverClaims[c];
+                    waiverClaims.erase(waiverClaims.begin() + c);
+                    if (addFreeAgent(team, claim.playerId, claim.dropId)) {
+                        waiverOrder.erase(waiverOrder.begin() + rank);
+                        waiverOrder.push_back(team);
+                        awarded++;
+                        progress = true;
+                        break;
+                    }
+                }
+            }
+        }
+        waiverClaims.clear();
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::PROCESS_WAIVERS);
+        }
+        return awarded;
+    }
+    
+    // Swap players between two teams. Each list must hold distinct players from that
+    // team's roster, and both rosters must stay within the limit afterwards. Traded
+    // players leave their old team's lineup.
+    bool tradePlayers(Team* first, const std::vector<int>& firstGives, Team* second, const std::vector<int>& secondGives) {
+        Mutation mutation(*this);
+        if (first == second || (firstGives.empty() && secondGives.empty())) {
+            *messages << "A trade needs two different teams and at least one player.\n";
+            return false;
+        }
+        auto owns = [this](const Team* team, const std::vector<int>& ids) {
+            for (size_t i = 0; i < ids.size(); ++i) {
+                const PlayerHandle* handle = playerIndex.find(ids[i]);
+                if (!handle || handle->owner != team || std::find(ids.begin(), ids.begin() + i, ids[i]) != ids.begin() + i) {
+                    *messages << "Player ID " << ids[i] << " cannot be traded by " << team->getName() << ".\n";
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (!owns(first, firstGives) || !owns(second, secondGives)) {
+            return false;
+        }
+        int firstSize = first->getRosterSize() - static_cast<int>(firstGives.size()) + static_cast<int>(secondGives.size());
+        int secondSize = second->getRosterSize() - static_cast<int>(secondGives.size()) + static_cast<int>(firstGives.size());
+        if (firstSize > rosterSize || secondSize > rosterSize) {
+            *messages << "The trade would leave a roster over " << rosterSize << " players.\n";
+            return false;
+        }
+        
+        auto move = [this](Team* from, Team* to, int id) {
+            PlayerHandle* handle = playerIndex.find(id);
+            from->removePlayer(id);
+            to->addPlayer(handle->player);
+            handle->owner = to;
+        };
+        for (int id : firstGives) {
+            move(first, second, id);
+        }
+        for (int id : secondGives) {
+            move(second, first, id);
+        }
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::TRADE, TransactionLog::Record().add(first->getName()).add(firstGives)
+                                                                             .add(second->getName()).add(secondGives));
+        }
+        *messages << first->getName() << " and " << second->getName() << " completed a trade.\n";
+        return true;
+    }
+    
+    // Set team lineup
+    bool setTeamLineup(Team* team, const std::vector<int>& playerIds) {
+        Mutation mutation(*this);
+        if (playerIds.size() != lineupSize) {
+            *messages << "Lineup must have exactly " << lineupSize << " players.\n";
+            return false;
+        }
+        
+        if (team->setLineup(playerIds)) {
+            if (mutation.logged()) {
+                mutation.log(TransactionLog::Op::LINEUP, TransactionLog::Record().add(team->getName()).add(playerIds));
+            }
+            *messages << "Lineup for " << team->getName() << " has been set.\n";
+            return true;
+        } else {
+            *messages << "Failed to set lineup. Please check player IDs.\n";
+            return false;
+        }
+    }
+    
+    // Slot rules used by the lineup optimizer; must have lineupSize entries
+    bool setLineupSlots(const std::vector<LineupSlot>& slots) {
+        if (static_cast<int>(slots.size()) != lineupSize) {
+            return false;
+        }
+        lineupSlots = slots;
+        return true;
+    }
+    
+    const std::vector<LineupSlot>& getLineupSlots() const { return lineupSlots; }
+    
+    // Score every game from now on with these rules; points already scored stay as they are
+    void setScoringRules(const ScoringRules& rules) {
+        Mutation mutation(*this);
+        scoringRules = rules;
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::SCORING, scoringRecord(rules));
+        }
+    }
+    
+    const ScoringRules& getScoringRules() const { return scoringRules; }
+    
+    // Projected game score of a team's current lineup
+    Scoring::Projection projectLineup(const Team* team) const {
+        Scoring::Projection total{0.0, 0.0};
+        for (const Player* player : team->getActiveLineup()) {
+            Scoring::Projection projection = projectPlayer(*player, scoringRules);
+            total.mean += projection.mean;
+            total.variance += projection.variance;
+        }
+        return total;
+    }
+    
+    // Set the team's lineup to the one with the best projection. When maximizing win
+    // probability, the opponent is this week's unplayed matchup with its current lineup;
+    // without one, the lineup is optimized for expected points instead.
+    bool optimizeLineup(Team* team, bool maximizeWinProbability = false) {
+        LineupOptimizer optimizer(lineupSlots);
+        const Team* opponent = nullptr;
+        if (maximizeWinProbability) {
+            for (const Matchup* matchup : schedule) {
+                if (matchup->getIsCompleted()) {
+                    continue;
+                }
+                opponent = matchup->getHomeTeam() == team ? matchup->getAwayTeam()
+                         : matchup->getAwayTeam() == team ? matchup->getHomeTeam() : nullptr;
+                if (opponent) {
+                    optimizer.setObjective(LineupOptimizer::Objective::WIN_PROBABILITY, projectLineup(opponent));
+                    break;
+                }
+            }
+            if (!opponent) {
+                *messages << team->getName() << " has no unplayed matchup this week; optimizing for expected points.\n";
+            }
+        }
+        
+        LineupOptimizer::Result result = optimizer.optimize(team->getRoster(), scoringRules);
+        if (!result.feasible) {
+            *messages << team->getName() << "'s roster cannot fill every lineup slot.\n";
+            return false;
+        }
+        
+        std::vector<int> ids;
+        for (const Player* player : result.lineup) {
+            ids.push_back(player->getId());
+        }
+        if (!setTeamLineup(team, ids)) {
+            return false;
+        }
+        *messages << "Projected " << std::fixed << std::setprecision(1) << result.mean << " points";
+        if (opponent) {
+            *messages << ", " << result.winProbability * 100.0 << "% to win";
+        }
+        *messages << ".\n";
+        return true;
+    }
+    
+    // Optimize every team's lineup for expected points, in parallel; returns the number of
+    // teams whose roster could fill all slots
+    size_t optimizeAllLineups() {
+        std::vector<LineupOptimizer::Result> results(teams.size());
+        ThreadPool::shared().parallelFor(teams.size(), TEAMS_PER_TASK, [this, &results](size_t begin, size_t end) {
+            LineupOptimizer optimizer(lineupSlots);
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = optimizer.optimize(teams[i]->getRoster(), scoringRules);
+            }
+        });
+        
+        Mutation mutation(*this);
+        size_t optimized = 0;
+        std::vector<int> ids;
+        for (size_t i = 0; i < teams.size(); ++i) {
+            if (!results[i].feasible) {
+                continue;
+            }
+            ids.clear();
+            for (const Player* player : results[i].lineup) {
+                ids.push_back(player->getId());
+            }
+            if (!teams[i]->setLineup(ids)) {
+                continue;
+            }
+            optimized++;
+            if (mutation.logged()) {
+                mutation.log(TransactionLog::Op::LINEUP, TransactionLog::Record().add(teams[i]->getName()).add(ids));
+            }
+        }
+        *messages << "Optimized lineups for " << optimized << " of " << teams.size() << " teams.\n";
+        return optimized;
+    }
+    
+    // Generate matchups for the current week
+    bool generateMatchups() {
+        Trace::Scope trace("generateMatchups");
+        // The pairings follow from the league state, so the record needs no payload
+        Mutation mutation(*this);
+        if (mutation.logged()) {
+            mutation.log(TransactionLog::Op::GENERATE_MATCHUPS);
+        }
+        // Clear previous matchups; their pool slots are reused below
+        for (auto& matchup : schedule) {
+            matchupStore.destroy(matchup);
+        }
+        schedule.clear();
+        
+        // We need at least 2 teams for matchups
+        if (teams.size() < 2) {
+            *messages << "Need at least 2 teams to generate matchups.\n";
+            return false;
+        }
+        
+        // Take this week's games from the season plan; past the regular season it repeats
+        const SeasonSchedule& plan = seasonSchedule();
+        if (plan.getWeekCount() == 0) {
+            *messages << "The season has no weeks scheduled.\n";
+            return false;
+        }
+        SeasonSchedule::Week week = plan.week((currentWeek - 1) % plan.getWeekCount());
+        
+        for (const SeasonSchedule::Game& game : week) {
+            Team* home = teams[game.home];
+            Team* away = teams[game.away];
+            Matchup* matchup = matchupStore.create(home, away);
+            if (hasSeed) {
+                matchup->setSeed(Random::deriveSeed(seed, (static_cast<uint64_t>(currentWeek) << 32) | schedule.size()));
+            }
+            schedule.push_back(matchup);
+            
+            *messages << "Matchup: " << home->getName() << " vs " << away->getName() << '\n';
+        }
+        
+        // Teams without a game this week have a bye
+        if (week.size() * 2 < teams.size()) {
+            std::vector<char> playing(teams.size(), 0);
+            for (const SeasonSchedule::Game& game : week) {
+                playing[game.home] = playing[game.away] = 1;
+            }
+            for (size_t t = 0; t < teams.size(); ++t) {
+                if (!playing[t]) {
+                    *messages << teams[t]->getName() << " has a bye this week.\n";
+                }
+            }
+        }
+        return true;
+    }
+    
+    // Simulate all matchups for the current week
+    bool simulateWeek() {
+        Trace::Scope trace("simulateWeek");
+        if (schedule.empty()) {
+            *messages << "No matchups scheduled. Generate matchups first.\n";
+            return false;
+        }
+        // Playing a completed matchup again would give its players a second game
+        if (std::all_of(schedule.begin(), schedule.end(), [](const auto& matchup) { return matchup->getIsCompleted(); })) {
+            *messages << "This week's matchups have already been played. Generate matchups first.\n";
+            return false;
+        }
+        
+        *messages << "\n==== SIMULATING WEEK " << currentWeek << " ====\n";
+        
+        // Give every matchup its own random stream up front, so the scores do not depend
+        // on which thread plays it
+        for (auto& matchup : schedule) {
+            if (!matchup->isSeeded()) {
+                matchup->setSeed(Random::engine()());
+            }
+        }
+        
+        // With the seeds logged, replaying the week reproduces every score
+        Mutation mutation(*this);
+        if (mutation.logged()) {
+            TransactionLog::Record record;
+            record.add(static_cast<int32_t>(schedule.size()));
+            for (const auto& matchup : schedule) {
+                record.add(matchup->getSeed());
+            }
+            mutation.log(TransactionLog::Op::SIMULATE_WEEK, record);
+        }
+        
+        // Each team plays once a week, so the matchups are independent and each task can
+        // play its range of them as one batch
+        std::vector<char> played(schedule.size());
+        {
+            Trace::Scope trace("playMatchups");
+            ThreadPool::shared().parallelFor(schedule.size(), MATCHUPS_PER_TASK, [this, &played](size_t begin, size_t end) {
+                playMatchups(begin, end, played);
+            });
+        }
+        
+        // Record and report results in schedule order; standings are shared, so this is serial
+        Trace::Scope recordTrace("recordResults");
+        standings.beginBatch();
+        for (size_t i = 0; i < schedule.size(); ++i) {
+            if (played[i]) {
+                schedule[i]->recordResult();
+            } else if (!schedule[i]->getIsCompleted()) {
+                *messages << "Warning: One or both teams don't have an active lineup. Skipping matchup.\n";
+            }
+            schedule[i]->displayResults(*messages);
+        }
+        standings.endBatch();
+        history.capture(currentWeek);
+        
+        // Advance to next week
+        currentWeek++;
+        return true;
+    }
+    
+    // Team, owner, record and points cells shared by the team tables
+    static void writeTeamCells(ReportWriter& report, const Team* team) {
+        char record[32] = {};
+        char* end = std::to_chars(record, record + 15, team->getWins()).ptr;
+        end[0] = '-';
+        end = std::to_chars(end + 1, record + sizeof(record), team->getLosses()).ptr;
+        
+        report.cell(team->getName());
+        report.cell(team->getOwner());
+        report.cell(std::string_view(record, end - record));
+        report.cell(team->getTotalPoints());
+        report.endRow();
+    }
+    
+    // Write the standings table into a report
+    void writeStandings(ReportWriter& report, std::string_view title = {}) const {
+        // Teams are kept in order by wins, then points, as results come in
+        report.beginTable(title, {{"Rank", 5, false}, {"Team", 20, false}, {"Owner", 20, false},
+                                  {"Record", 10, false}, {"Points", 10, false}});
+        for (size_t i = 0; i < standings.size(); ++i) {
+            report.cell(i + 1);
+            writeTeamCells(report, standings.at(i));
+        }
+        report.endTable();
+    }
+    
+    // Display league standings
+    void displayStandings(ReportWriter& report) const {
+        Trace::Scope trace("report:standings");
+        report.beginReport("LEAGUE STANDINGS");
+        
+        if (teams.empty()) {
+            report.note("No teams registered yet.");
+        } else {
+            writeStandings(report);
+        }
+        report.endReport();
+    }
+    
+    void displayStandings() const {
+        displayStandings(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Display all player statistics
+    void displayPlayerStatistics(ReportWriter& report) const {
+        Trace::Scope trace("report:players");
+        report.beginReport("PLAYER STATISTICS");
+        
+        // Create a vector of all players (from teams and available)
+        std::vector<Player*> allPlayers;
+        
+        // Add players from teams
+        for (const auto& team : teams) {
+            const auto& roster = team->getRoster();
+            allPlayers.insert(allPlayers.end(), roster.begin(), roster.end());
+        }
+        
+        // Add available players
+        availablePlayers.forEach([&allPlayers](Player* player) { allPlayers.push_back(player); });
+        
+        // Sort players by fantasy points (descending)
+        std::sort(allPlayers.begin(), allPlayers.end(), [](const Player* a, const Player* b) {
+            return a->getFantasyPoints() > b->getFantasyPoints();
+        });
+        
+        // Display players
+        Player::beginTable(report);
+        for (const auto& player : allPlayers) {
+            if (player->getFantasyPoints() > 0) { // Only show players with points
+                player->writeRow(report);
+            }
+        }
+        report.endTable();
+        report.endReport();
+    }
+    
+    void displayPlayerStatistics() const {
+        displayPlayerStatistics(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Display weekly report
+    void weeklyReport(ReportWriter& report) const {
+        Trace::Scope trace("report:weekly");
+        report.beginReport("WEEK " + std::to_string(currentWeek - 1) + " REPORT");
+        
+        if (schedule.empty()) {
+            report.note("No matchups have been simulated yet.");
+            report.endReport();
+            return;
+        }
+        
+        // Show matchup results
+        report.beginTable("MATCHUP RESULTS", {{"Home", 20, false}, {"Away", 20, false},
+                                              {"Home Pts", 8, true}, {"Away Pts", 8, true}});
+        for (const auto& matchup : schedule) {
+            if (matchup->getIsCompleted()) {
+                report.cell(matchup->getHomeTeam()->getName());
+                report.cell(matchup->getAwayTeam()->getName());
+                report.cell(matchup->getHomeScore());
+                report.cell(matchup->getAwayScore());
+                report.endRow();
+            }
+        }
+        report.endTable();
+        
+        // Show team standings
+        writeStandings(report, "LEAGUE STANDINGS");
+        
+        // Display the week's top 5 players (or fewer if fewer scored)
+        Player::beginTable(report, "TOP PERFORMERS");
+        for (const StatHistory::Leader& leader : history.top(5, currentWeek - 1, currentWeek - 1)) {
+            leader.player->writeRow(report, leader.points);
+        }
+        report.endTable();
+        report.endReport();
+    }
+    
+    void weeklyReport() const {
+        weeklyReport(TextReportWriter::console());
+        TextReportWriter::console().flush(std::cout);
+    }
+    
+    // Getters
+    int getCurrentWeek() const { return currentWeek; }
+    int getTeamCount() const { return teams.size(); }
+    int getMaxTeams() const { return maxTeams; }
+    int getRosterSize() const { return rosterSize; }
+    int getLineupSize() const { return lineupSize; }
+    int getSeasonWeeks() const { return seasonWeeks; }
+    int getMaxPlayerId() const { return maxPlayerId; }
+    bool isSeeded() const { return hasSeed; }
+    uint64_t getSeed() const { return seed; }
+    
+    // Get team by index
+    Team* getTeam(int index) {
+        if (index >= 0 && index < static_cast<int>(teams.size())) {
+            return teams[index];
+        }
+        return nullptr;
+    }
+    
+    // Get current week's matchups
+    const std::vector<Matchup*>& getSchedule() const {
+        return schedule;
+    }
+    
+    // Get the undrafted player pool
+    const PlayerPool& getAvailablePlayers() const {
+        return availablePlayers;
+    }
+    
+    // Get teams in standings order
+    const Standings& getStandings() const {
+        return standings;
+    }
+    
+    // Get the week-by-week stat log of every player
+    const StatHistory& getHistory() const {
+        return history;
+    }
+    
+    // Get team by name
+    Team* getTeamByName(const std::string& teamName) {
+        auto it = teamsByName.find(teamName);
+        return it != teamsByName.end() ? it->second : nullptr;
+    }
+    
+    // Get available player by ID; a player is available while the index gives it no owner
+    Player* getAvailablePlayerById(int id) {
+        const PlayerHandle* handle = playerIndex.find(id);
+        return handle && !handle->owner ? handle->player : nullptr;
+    }
+    
+    // Get player by ID from all players (teams and available)
+    Player* getPlayerById(int id) {
+        const PlayerHandle* handle = playerIndex.find(id);
+        return handle ? handle->player : nullptr;
+    }
+    
+    // Get the team that owns a player, or nullptr if the player is available
+    Team* getPlayerOwner(int id) {
+        const PlayerHandle* handle = playerIndex.find(id);
+        return handle ? handle->owner : nullptr;
+    }
+    
+    // Check if all teams have full rosters
+    bool allTeamsHaveFullRosters() const {
+        for (const auto& team : teams) {
+            if (team->getRosterSize() < rosterSize) {
+                return false;
+            }
+        }
+        return !teams.empty(); // Only return true if there are teams and they all have full rosters
+    }
+};
+
+// Snake drafts ranked by value over replacement (VOR): a player's projected points minus
+// those of the player at the same position who would be the first one left over once
+// every team has filled its starting slots. Each position keeps a max-heap of candidates;
+// drafted players are skipped when they surface (lazy deletion), so a pick is O(log n).
+// mock() plays a draft without touching the league, run() drafts for real.
+class AutoDraft {
+public:
+    struct Pick {
+        int round;
+        Team* team;
+        Player* player;
+        double value;
+    };
+
+private:
+    struct Candidate {
+        double value;
+        int index;
+        
+        // Max-heap order: higher value first, then lower index (earlier in the pool)
+        bool operator<(const Candidate& other) const {
+            return value < other.value || (value == other.value && index > other.index);
+        }
+    };
+    
+    League& league;
+    std::vector<Player*> players;           // available when the draft was set up
+    std::vector<double> values;             // VOR by player index
+    std::array<std::vector<Candidate>, POSITION_COUNT> initialHeaps;
+    std::array<int, POSITION_COUNT> required;    // dedicated starting slots
+    std::array<int, POSITION_COUNT> maximum;     // most players a team may take
+    int flexSlots;
+    unsigned flexPositions;
+    double jitter;
+    Random::Engine jitterEngine;
+    
+    // Per-draft state, reused between drafts
+    std::array<std::vector<Candidate>, POSITION_COUNT> heaps;
+    std::vector<char> taken;
+    std::vector<std::array<int, POSITION_COUNT>> counts;
+    std::vector<int> rosterCounts;
+    
+    bool isFlex(int pos) const {
+        return (flexPositions & (1u << pos)) != 0;
+    }
+    
+    // Top untaken candidate at a position, discarding taken ones on the way
+    const Candidate* top(int pos) {
+        std::vector<Candidate>& heap = heaps[pos];
+        while (!heap.empty() && taken[heap.front().index]) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+        return heap.empty() ? nullptr : &heap.front();
+    }
+    
+    // Positions a team may draft next, and in `starters` those that would fill an open
+    // starting slot. When its remaining picks are only just enough for its open starting
+    // slots, only those positions are allowed.
+    unsigned allowedPositions(size_t team, unsigned& starters) const {
+        const std::array<int, POSITION_COUNT>& count = counts[team];
+        int dedicatedOpen = 0;
+        int flexUsed = 0;
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            dedicatedOpen += std::max(0, required[pos] - count[pos]);
+            if (isFlex(pos)) {
+                flexUsed += std::max(0, count[pos] - required[pos]);
+            }
+        }
+        int flexOpen = std::max(0, flexSlots - flexUsed);
+        int picksLeft = league.getRosterSize() - rosterCounts[team];
+        
+        unsigned allowed = 0;
+        starters = 0;
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            bool fillsStarter = count[pos] < required[pos] || (isFlex(pos) && flexOpen > 0);
+            if (fillsStarter) {
+                starters |= 1u << pos;
+            }
+            if (picksLeft <= dedicatedOpen + flexOpen ? fillsStarter : count[pos] < maximum[pos]) {
+                allowed |= 1u << pos;
+            }
+        }
+        return allowed;
+    }
+    
+    // Best candidate among the allowed positions, or -1. On equal value a player who
+    // fills an open starting slot goes before a bench pick.
+    int choose(unsigned allowed, unsigned starters) {
+        const Candidate* best = nullptr;
+        bool bestStarts = false;
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            if (!(allowed & (1u << pos))) {
+                continue;
+            }
+            const Candidate* candidate = top(pos);
+            if (!candidate) {
+                continue;
+            }
+            bool starts = (starters & (1u << pos)) != 0;
+            if (!best || candidate->value > best->value ||
+                (candidate->value == best->value && (starts > bestStarts || (starts == bestStarts && *best < *candidate)))) {
+                best = candidate;
+                bestStarts = starts;
+            }
+        }
+        return best ? best->index : -1;
+    }
+    
+    void reset() {
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            heaps[pos] = initialHeaps[pos];
+            if (jitter > 0.0) {
+                for (Candidate& candidate : heaps[pos]) {
+                    double noise = static_cast<double>(jitterEngine() >> 11) * 0x1.0p-53;
+                    candidate.value += (noise * 2.0 - 1.0) * jitter;
+                }
+                std::make_heap(heaps[pos].begin(), heaps[pos].end());
+            }
+        }
+        taken.assign(players.size(), 0);
+        
+        size_t teamCount = static_cast<size_t>(league.getTeamCount());
+        counts.assign(teamCount, {});
+        rosterCounts.assign(teamCount, 0);
+        for (size_t t = 0; t < teamCount; ++t) {
+            for (const Player* player : league.getTeam(static_cast<int>(t))->getRoster()) {
+                counts[t][static_cast<int>(player->getPosition())]++;
+                rosterCounts[t]++;
+            }
+        }
+    }
+
+public:
+    // Rank the league's currently available players
+    explicit AutoDraft(League& league)
+        : league(league), required{}, maximum{}, flexSlots(0), flexPositions(0), jitter(0.0) {
+        league.getAvailablePlayers().forEach([this](Player* player) { players.push_back(player); });
+        
+        // Starting slots per position; FLEX slots are shared by the positions they accept
+        unsigned dedicated[POSITION_COUNT] = {};
+        for (const LineupSlot& slot : league.getLineupSlots()) {
+            int accepted = 0;
+            for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+                if (slot.accepts(static_cast<Position>(pos))) {
+                    accepted++;
+                    dedicated[pos]++;
+                }
+            }
+            if (accepted > 1) {
+                flexSlots++;
+                flexPositions |= slot.positions;
+                for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+                    if (slot.accepts(static_cast<Position>(pos))) {
+                        dedicated[pos]--;
+                    }
+                }
+            }
+        }
+        int bench = std::max(0, league.getRosterSize() - league.getLineupSize());
+        int flexCount = 0;
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            required[pos] = static_cast<int>(dedicated[pos]);
+            flexCount += isFlex(pos);
+        }
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            maximum[pos] = isFlex(pos) ? required[pos] + flexSlots + bench : required[pos] + std::min(1, bench);
+        }
+        
+        // Replacement level: the best player left after every team starts its share
+        std::array<std::vector<double>, POSITION_COUNT> means;
+        std::vector<double> projected(players.size());
+        for (size_t i = 0; i < players.size(); ++i) {
+            projected[i] = projectPlayer(*players[i], league.getScoringRules()).mean;
+            means[static_cast<int>(players[i]->getPosition())].push_back(projected[i]);
+        }
+        double replacement[POSITION_COUNT] = {};
+        for (int pos = 0; pos < POSITION_COUNT; ++pos) {
+            std::vector<double>& list = means[pos];
+            if (list.empty()) {
+                continue;
+            }
+            double share = required[pos] + (isFlex(pos) && flexCount > 0 ? double(flexSlots) / flexCount : 0.0);
+            size_t rank = std::min(list.size() - 1, static_cast<size_t>(share * league.getTeamCount()));
+            std::nth_element(list.begin(), list.begin() + rank, list.end(), std::greater<double>());
+            replacement[pos] = list[rank];
+        }
+        
+        values.resize(players.size());
+        for (size_t i = 0; i < players.size(); ++i) {
+            int pos = static_cast<int>(players[i]->getPosition());
+            values[i] = projected[i] - replacement[pos];
+            initialHeaps[pos].push_back({values[i], static_cast<int>(i)});
+        }
+        
+        // No position can supply more picks than the whole draft makes, so deeper players
+        // are dropped and every draft starts from small heaps
+        size_t draftPicks = static_cast<size_t>(league.getTeamCount()) * std::max(0, league.getRosterSize());
+        for (auto& heap : initialHeaps) {
+            if (heap.size() > draftPicks) {
+                std::nth_element(heap.begin(), heap.begin() + draftPicks, heap.end(),
+                                 [](const Candidate& a, const Candidate& b) { return b < a; });
+                heap.resize(draftPicks);
+            }
+            std::make_heap(heap.begin(), heap.end());
+        }
+    }
+    
+    // Randomize each draft by adding uniform noise of +/- points to every value. Only the
+    // players that could be drafted without noise are candidates.
+    void setJitter(double points, uint64_t seed) {
+        jitter = points;
+        jitterEngine.seed(seed);
+    }
+    
+    // Play a snake draft for every team until rosters are full or the pool runs out,
+    // without changing the league. Picks are appended to `picks` in draft order.
+    void mock(std::vector<Pick>& picks) {
+        reset();
+        size_t teamCount = counts.size();
+        int rosterSize = league.getRosterSize();
+        
+        for (int round = 0; ; ++round) {
+            bool anyPick = false;
+            for (size_t turn = 0; turn < teamCount; ++turn) {
+                size_t team = round % 2 == 0 ? turn : teamCount - 1 - turn;
+                if (rosterCounts[team] >= rosterSize) {
+                    continue;
+                }
+                unsigned starters = 0;
+                unsigned allowed = allowedPositions(team, starters);
+                int index = choose(allowed, starters);
+                if (index < 0) {
+                    // Nothing left at the needed positions: take the best player of any kind
+                    index = choose((1u << POSITION_COUNT) - 1, starters);
+                }
+                if (index < 0) {
+                    return;
+                }
+                taken[index] = 1;
+                counts[team][static_cast<int>(players[index]->getPosition())]++;
+                rosterCounts[team]++;
+                picks.push_back({round + 1, league.getTeam(static_cast<int>(team)), players[index], values[index]});
+                anyPick = true;
+            }
+            if (!anyPick) {
+                return;
+            }
+        }
+    }
+    
+    // Draft for real: play the snake draft and make each pick in the league
+    std::vector<Pick> run() {
+        std::vector<Pick> picks;
+        mock(picks);
+        for (const Pick& pick : picks) {
+            league.draftPlayer(pick.team, pick.player->getId());
+        }
+        return picks;
+    }
+};
+
+// What-if evaluation of trades. The constructor captures every team's roster projections,
+// best-lineup projection and remaining opponents once. A trade is evaluated on an overlay:
+// the two teams involved get new rosters and re-optimized lineups while every other team
+// is read from the shared base state (copy-on-write), so no League is cloned and thousands
+// of candidate trades can be scored per second. Each remaining game is a normal
+// approximation of the difference between the two lineups' projected scores.
+class TradeAnalyzer {
+public:
+    // One team's outlook for the rest of the season
+    struct Outlook {
+        double projectedPoints;     // best lineup's projected points per game
+        double winProbability;      // average chance to win a remaining game
+        double expectedWins;        // wins so far plus expected remaining wins
+    };
+    
+    struct Side {
+        Outlook before;
+        Outlook after;
+    };
+    
+    struct Evaluation {
+        bool valid;
+        Side first;
+        Side second;
+    };
+    
+    // A one-for-one trade that helps both teams
+    struct Suggestion {
+        Team* partner;
+        const Player* gives;
+        const Player* receives;
+        Evaluation evaluation;
+    };
+
+private:
+    struct TeamState {
+        Team* team;
+        std::vector<Player*> roster;
+        std::vector<Scoring::Projection> projections;   // parallel to roster
+        Scoring::Projection lineup;
+        int wins;
+    };
+    
+    // Teams whose lineup differs from the base in one scenario
+    struct Overlay {
+        int team[2];
+        Scoring::Projection lineup[2];
+    };
+    
+    LineupOptimizer optimizer;
+    int rosterLimit;
+    std::vector<TeamState> base;
+    std::unordered_map<const Team*, int> indexOf;
+    std::vector<uint32_t> opponentStart;    // team t's remaining opponents are
+    std::vector<uint32_t> opponents;        // opponents[opponentStart[t], opponentStart[t + 1])
+    // Scratch rosters for the two sides of the trade being evaluated
+    std::vector<Player*> rosterScratch[2];
+    std::vector<Scoring::Projection> projectionScratch[2];
+    
+    Scoring::Projection bestLineup(const std::vector<Player*>& roster, const std::vector<Scoring::Projection>& projections) {
+        LineupOptimizer::Result result = optimizer.optimize(roster, projections);
+        return result.feasible ? Scoring::Projection{result.mean, result.variance} : Scoring::Projection{0.0, 0.0};
+    }
+    
+    const Scoring::Projection& lineupOf(int team, const Overlay& overlay) const {
+        return team == overlay.team[0] ? overlay.lineup[0]
+             : team == overlay.team[1] ? overlay.lineup[1] : base[team].lineup;
+    }
+    
+    Outlook outlook(int team, const Overlay& overlay) const {
+        const Scoring::Projection& mine = lineupOf(team, overlay);
+        double expected = 0.0;
+        for (uint32_t i = opponentStart[team]; i < opponentStart[team + 1]; ++i) {
+            const Scoring::Projection& theirs = lineupOf(static_cast<int>(opponents[i]), overlay);
+            double spread = std::sqrt(std::max(mine.variance + theirs.variance, 1e-9));
+            expected += 0.5 * std::erfc(-(mine.mean - theirs.mean) / (spread * std::sqrt(2.0)));
+        }
+        uint32_t games = opponentStart[team + 1] - opponentStart[team];
+        return {mine.mean, games ? expected / games : 0.0, base[team].wins + expected};
+    }
+    
+    // Roster of `side` after giving away `gives` and receiving `receives`, into scratch
+    bool tradedRoster(int side, const TeamState& state, const std::vector<int>& gives,
+                      const TeamState& partner, const std::vector<int>& receives) {
+        std::vector<Player*>& roster = rosterScratch[side];
+        std::vector<Scoring::Projection>& projections = projectionScratch[side];
+        roster.clear();
+        projections.clear();
+        size_t given = 0;
+        for (size_t i = 0; i < state.roster.size(); ++i) {
+            if (std::find(gives.begin(), gives.end(), state.roster[i]->getId()) != gives.end()) {
+                given++;
+                continue;
+            }
+            roster.push_back(state.roster[i]);
+            projections.push_back(state.projections[i]);
+        }
+        size_t received = 0;
+        for (size_t i = 0; i < partner.roster.size(); ++i) {
+            if (std::find(receives.begin(), receives.end(), partner.roster[i]->getId()) != receives.end()) {
+                roster.push_back(partner.roster[i]);
+                projections.push_back(partner.projections[i]);
+                received++;
+            }
+        }
+        return given == gives.size() && received == receives.size() && static_cast<int>(roster.size()) <= rosterLimit;
+    }
+
+public:
+    explicit TradeAnalyzer(League& league)
+        : optimizer(league.getLineupSlots()), rosterLimit(league.getRosterSize()) {
+        const ScoringRules& rules = league.getScoringRules();
+        const int teamCount = league.getTeamCount();
+        base.resize(teamCount);
+        for (int t = 0; t < teamCount; ++t) {
+            TeamState& state = base[t];
+            state.team = league.getTeam(t);
+            state.roster = state.team->getRoster();
+            for (const Player* player : state.roster) {
+                state.projections.push_back(projectPlayer(*player, rules));
+            }
+            state.lineup = bestLineup(state.roster, state.projections);
+            state.wins = state.team->getWins();
+            indexOf[state.team] = t;
+        }
+        
+        // Remaining regular-season opponents, team by team
+        const SeasonSchedule& plan = league.seasonSchedule();
+        std::vector<std::vector<uint32_t>> byTeam(teamCount);
+        for (int w = league.getCurrentWeek() - 1; w < plan.getWeekCount(); ++w) {
+            for (const SeasonSchedule::Game& game : plan.week(w)) {
+                byTeam[game.home].push_back(game.away);
+                byTeam[game.away].push_back(game.home);
+            }
+        }
+        opponentStart.push_back(0);
+        for (const auto& list : byTeam) {
+            opponents.insert(opponents.end(), list.begin(), list.end());
+            opponentStart.push_back(static_cast<uint32_t>(opponents.size()));
+        }
+    }
+    
+    // Current outlook of a team (all zeros if it is not in the league)
+    Outlook outlook(const Team* team) const {
+        auto it = indexOf.find(team);
+        return it == indexOf.end() ? Outlook{0.0, 0.0, 0.0} : outlook(it->second, Overlay{{-1, -1}, {}});
+    }
+    
+    // Both teams' outlook before and after `first` sends firstGives for secondGives.
+    // Invalid (valid == false) if a player is not on the giving roster or a roster would
+    // go over the limit.
+    Evaluation evaluate(const Team* first, const std::vector<int>& firstGives,
+                        const Team* second, const std::vector<int>& secondGives) {
+        Evaluation evaluation{};
+        auto a = indexOf.find(first);
+        auto b = indexOf.find(second);
+        if (a == indexOf.end() || b == indexOf.end() || a->second == b->second) {
+            return evaluation;
+        }
+        const int firstIndex = a->second;
+        const int secondIndex = b->second;
+        if (!tradedRoster(0, base[firstIndex], firstGives, base[secondIndex], secondGives)
+            || !tradedRoster(1, base[secondIndex], secondGives, base[firstIndex], firstGives)) {
+            return evaluation;
+        }
+        
+        Overlay before{{-1, -1}, {}};
+        Overlay after{{firstIndex, secondIndex},
+                      {bestLineup(rosterScratch[0], projectionScratch[0]), bestLineup(rosterScratch[1], projectionScratch[1])}};
+        evaluation.valid = true;
+        evaluation.first = {outlook(firstIndex, before), outlook(firstIndex, after)};
+        evaluation.second = {outlook(secondIndex, before), outlook(secondIndex, after)};
+        return evaluation;
+    }
+    
+    // One-for-one trades with any other team that raise both teams' expected wins, best
+    // for `team` first
+    std::vector<Suggestion> suggest(const Team* team, size_t limit) {
+        auto better = [](const Suggestion& x, const Suggestion& y) {
+            return x.evaluation.first.after.expectedWins > y.evaluation.first.after.expectedWins;
+        };
+        auto best = makeTopK<Suggestion>(limit, better);
+        auto it = indexOf.find(team);
+        if (it == indexOf.end()) {
+            return best.sorted();
+        }
+        
+        std::vector<int> gives(1), receives(1);
+        const TeamState& mine = base[it->second];
+        for (const TeamState& partner : base) {
+            if (partner.team == team) {
+                continue;
+            }
+            for (Player* out : mine.roster) {
+                for (Player* in : partner.roster) {
+                    gives[0] = out->getId();
+                    receives[0] = in->getId();
+                    Evaluation evaluation = evaluate(team, gives, partner.team, receives);
+                    if (evaluation.valid
+                        && evaluation.first.after.expectedWins > evaluation.first.before.expectedWins
+                        && evaluation.second.after.expectedWins > evaluation.second.before.expectedWins) {
+                        best.push({partner.team, out, in, evaluation});
+                    }
+                }
+            }
+        }
+        return best.sorted();
+    }
+};
+
+// Hosts many leagues in one process. Leagues are partitioned across shards; each shard
+// has one worker thread that owns its leagues outright, so League code runs without locks.
+// Every request for a league, from any thread, is queued to its shard's MPSC queue and
+// executed there in submission order.
+class LeagueRegistry {
+public:
+    using LeagueId = int;
+
+private:
+    struct Shard;
+    
+    struct Task {
+        std::atomic<Task*> next{nullptr};
+        std::function<void(Shard&)> run;
+    };
+    
+    struct Shard {
+        MpscQueue<Task> queue;
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> stopping{false};
+        std::mutex sleepMutex;
+        std::condition_variable wakeUp;
+        std::thread worker;
+        // Owned by the worker thread only
+        IdMap<League*> leagues;
+        std::ostream messages{nullptr};
+        
+        void post(Task* task) {
+            pending.fetch_add(1);
+            queue.push(task);
+            if (sleeping.load()) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                wakeUp.notify_one();
+            }
+        }
+        
+        void run() {
+            while (true) {
+                if (Task* task = queue.pop()) {
+                    // Requests with a future report their errors through it; nothing else
+                    // may leave the worker, or the process terminates
+                    try {
+                        task->run(*this);
+                    } catch (...) {
+                    }
+                    delete task;
+                    pending.fetch_sub(1);
+                    continue;
+                }
+                if (pending.load() > 0) {
+                    // A producer is between its exchange and its link; it is about to land
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (stopping.load()) {
+                    break;
+                }
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleeping.store(true);
+                wakeUp.wait(lock, [this] { return pending.load() > 0 || stopping.load(); });
+                sleeping.store(false);
+            }
+            leagues.forEach([](int, League* league) { delete league; });
+            leagues.clear();
+        }
+    };
+    
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<LeagueId> nextId{1};
+    std::atomic<size_t> leagueCount{0};
+    
+    Shard& shardFor(LeagueId id) {
+        return *shards[static_cast<size_t>(id) % shards.size()];
+    }
+    
+    template <typename Fn>
+    void post(Shard& shard, Fn fn) {
+        Task* task = new Task;
+        task->run = std::move(fn);
+        shard.post(task);
+    }
+
+public:
+    explicit LeagueRegistry(size_t shardCount = std::max(1u, std::thread::hardware_concurrency())) {
+        for (size_t i = 0; i < std::max<size_t>(1, shardCount); ++i) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+        for (auto& shard : shards) {
+            Shard* owner = shard.get();
+            owner->worker = std::thread([owner] { owner->run(); });
+        }
+    }
+    
+    // Runs every queued request, then stops the workers and destroys the leagues
+    ~LeagueRegistry() {
+        for (auto& shard : shards) {
+            {
+                std::lock_guard<std::mutex> lock(shard->sleepMutex);
+                shard->stopping.store(true);
+            }
+            shard->wakeUp.notify_one();
+        }
+        for (auto& shard : shards) {
+            shard->worker.join();
+        }
+    }
+    
+    LeagueRegistry(const LeagueRegistry&) = delete;
+    LeagueRegistry& operator=(const LeagueRegistry&) = delete;
+    
+    size_t getShardCount() const { return shards.size(); }
+    size_t getLeagueCount() const { return leagueCount.load(); }
+    
+    // Create a league on its shard. The ID is usable immediately: requests queued for it
+    // run after the constructor. League messages are discarded.
+    LeagueId createLeague(const std::string& name, int maxTeams, int rosterSize, int lineupSize,
+                          bool loadDefaultPlayers = true) {
+        LeagueId id = nextId.fetch_add(1);
+        leagueCount.fetch_add(1);
+        post(shardFor(id), [=](Shard& shard) {
+            League* league = new League(name, maxTeams, rosterSize, lineupSize, loadDefaultPlayers);
+            league->setMessageStream(shard.messages);
+            shard.leagues.insert(id, league);
+        });
+        return id;
+    }
+    
+    // Queue a request for a league; fn(League&) runs on the owning shard. Returns a future
+    // for fn's result, or for what fn threw; it holds std::out_of_range if the league does
+    // not exist.
+    template <typename Fn>
+    auto execute(LeagueId id, Fn fn) -> std::future<decltype(fn(std::declval<League&>()))> {
+        using Result = decltype(fn(std::declval<League&>()));
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> result = promise->get_future();
+        post(shardFor(id), [id, promise, fn = std::move(fn)](Shard& shard) mutable {
+            League** league = shard.leagues.find(id);
+            if (!league) {
+                promise->set_exception(std::make_exception_ptr(
+                    std::out_of_range("no league with id " + std::to_string(id))));
+                return;
+            }
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    fn(**league);
+                    promise->set_value();
+                } else {
+                    promise->set_value(fn(**league));
+                }
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return result;
+    }
+    
+    // Remove a league after the requests already queued for it
+    void removeLeague(LeagueId id) {
+        post(shardFor(id), [this, id](Shard& shard) {
+            League** league = shard.leagues.find(id);
+            if (league) {
+                delete *league;
+                shard.leagues.erase(id);
+                leagueCount.fetch_sub(1);
+            }
+        });
+    }
+    
+    // Generate and simulate the next week in every league that is ready, all shards in
+    // parallel. Returns the number of leagues that played a week. If a league throws, the
+    // rest of its shard is skipped and the exception is rethrown once every shard is done.
+    size_t simulateWeekAll() {
+        std::atomic<size_t> simulated{0};
+        std::vector<std::future<void>> done;
+        for (auto& shard : shards) {
+            auto promise = std::make_shared<std::promise<void>>();
+            done.push_back(promise->get_future());
+            post(*shard, [promise, &simulated](Shard& owner) {
+                size_t count = 0;
+                std::exception_ptr error;
+                try {
+                    owner.leagues.forEach([&count](int, League* league) {
+                        if (league->generateMatchups() && league->simulateWeek()) {
+                            count++;
+                        }
+                    });
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                simulated.fetch_add(count);
+                if (error) {
+                    promise->set_exception(error);
+                } else {
+                    promise->set_value();
+                }
+            });
+        }
+        for (auto& shardDone : done) {
+            shardDone.wait();
+        }
+        for (auto& shardDone : done) {
+            shardDone.get();
+        }
+        return simulated.load();
+    }
+    
+    // Block until every request queued before this call has run
+    void drain() {
+        std::vector<std::future<void>> done;
+        for (auto& shard : shards) {
+            auto promise = std::make_shared<std::promise<void>>();
+            done.push_back(promise->get_future());
+            post(*shard, [promise](Shard&) { promise->set_value(); });
+        }
+        for (auto& shardDone : done) {
+            shardDone.wait();
+        }
+    }
+};
+
+// Non-interactive driver: executes one command per line from a script or stdin and writes
+// one JSON object per command. It never clears the screen or waits for Enter, and league
+// status messages are captured into the response instead of printed.
+//
+// Commands:
+//   seed <n>                     players <file>          load <file>     save <file>
+//   register <team> <owner>      draft <team> <id>       drop <team> <id>
+//   lineup <team> <id>...        optimize <team>|--all [points|win]
+//   autodraft                    generate                simulate
+//   report standings|teams|week|schedule|players [n]|available [pos]|leaders <from> <to> [n]
+//   season <weeks> <playoff teams> [<divisions> <division weeks>]
+//   add <team> <id> [drop id]    claim <team> <id> [drop id]    waivers
+//   trade|analyze <team> <ids> <team> <ids>    suggest <team> [n]
+//   export standings|teams|players|available|week text|csv|json <file>
+//   odds <seasons>               trace on|off|clear|export <file>
+//   scoring standard|half-ppr|ppr|<stat> <weight> [pos]
+//   rescore standard|half-ppr|ppr [n]
+//   journal <file>|off           checkpoint
+// Arguments containing spaces can be double-quoted; <ids> is a comma-separated list.
+// Lines starting with # are ignored. While a journal is open, a command reports ok only
+// once everything it logged is on disk; if the journal cannot be written, the command
+// fails and the league is no longer journaled.
+class BatchRunner {
+private:
+    League* league;
+    std::ostream& output;
+    std::ostringstream messages;
+    std::string response;
+    bool hasSeed;
+    uint64_t seed;
+    size_t failures;
+    std::string journalPath;    // every league this runner adopts is journaled here
+    
+    void adopt(League* replacement) {
+        delete league;
+        league = replacement;
+        league->setMessageStream(messages);
+        if (hasSeed) {
+            league->setSeed(seed);
+        }
+        if (!journalPath.empty() && !league->startJournal(journalPath)) {
+            journalPath.clear();
+        }
+    }
+    
+    // Finish the response for a failed command
+    bool fail(JsonWriter& json, const std::string& error) {
+        json.field("ok", false).field("error", error);
+        return false;
+    }
+    
+    // League status text collected while running the command, without trailing newlines
+    std::string takeMessages() {
+        std::string text = messages.str();
+        messages.str(std::string());
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+            text.pop_back();
+        }
+        size_t start = text.find_first_not_of('\n');
+        return start == std::string::npos ? std::string() : text.substr(start);
+    }
+    
+    // Parse a comma-separated list of player IDs
+    static bool parseIds(const std::string& text, std::vector<int>& ids) {
+        ids.clear();
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = std::min(text.find(',', start), text.size());
+            int id = 0;
+            if (!parseInt(text.substr(start, end - start), id)) {
+                return false;
+            }
+            ids.push_back(id);
+            start = end + 1;
+        }
+        return true;
+    }
+    
+    static void writeOutlook(JsonWriter& json, const char* name, const TradeAnalyzer::Outlook& outlook) {
+        json.key(name).beginObject()
+            .field("projected", outlook.projectedPoints)
+            .key("winProbability").value(outlook.winProbability, 4)
+            .field("expectedWins", outlook.expectedWins)
+            .endObject();
+    }
+    
+    static void writeSide(JsonWriter& json, const char* name, const Team* team, const TradeAnalyzer::Side& side) {
+        json.key(name).beginObject().field("team", team->getName());
+        writeOutlook(json, "before", side.before);
+        writeOutlook(json, "after", side.after);
+        json.endObject();
+    }
+    
+    Team* requireTeam(const std::string& teamName, JsonWriter& json) {
+        Team* team = league->getTeamByName(teamName);
+        if (!team) {
+            fail(json, "unknown team \"" + teamName + "\"");
+        }
+        return team;
+    }
+    
+    static void writePlayer(JsonWriter& json, const Player* player) {
+        json.beginObject()
+            .field("id", player->getId())
+            .field("name", player->getName())
+            .field("position", positionToString(player->getPosition()))
+            .field("team", player->getTeam())
+            .field("games", player->getGamesPlayed())
+            .field("points", player->getFantasyPoints())
+            .endObject();
+    }
+    
+    static void writeMatchup(JsonWriter& json, const Matchup* matchup) {
+        json.beginObject()
+            .field("home", matchup->getHomeTeam()->getName())
+            .field("away", matchup->getAwayTeam()->getName());
+        if (matchup->getIsCompleted()) {
+            json.field("homeScore", matchup->getHomeScore())
+                .field("awayScore", matchup->getAwayScore());
+        }
+        json.field("completed", matchup->getIsCompleted()).endObject();
+    }
+    
+    bool report(const std::vector<std::string>& args, JsonWriter& json) {
+        std::string what = args.size() > 1 ? args[1] : "standings";
+        
+        if (what == "standings") {
+            const Standings& standings = league->getStandings();
+            json.key("standings").beginArray();
+            for (size_t i = 0; i < standings.size(); ++i) {
+                const Team* team = standings.at(i);
+                json.beginObject()
+                    .field("rank", i + 1)
+                    .field("team", team->getName())
+                    .field("owner", team->getOwner())
+                    .field("wins", team->getWins())
+                    .field("losses", team->getLosses())
+                    .field("points", team->getTotalPoints())
+                    .endObject();
+            }
+            json.endArray();
+        } else if (what == "teams") {
+            json.key("teams").beginArray();
+            for (int i = 0; i < league->getTeamCount(); ++i) {
+                const Team* team = league->getTeam(i);
+                json.beginObject().field("team", team->getName()).field("owner", team->getOwner());
+                json.key("roster").beginArray();
+                for (const Player* player : team->getRoster()) {
+                    json.value(player->getId());
+                }
+                json.endArray().key("lineup").beginArray();
+                for (const Player* player : team->getActiveLineup()) {
+                    json.value(player->getId());
+                }
+                json.endArray().endObject();
+            }
+            json.endArray();
+        } else if (what == "week") {
+            json.field("week", league->getCurrentWeek() - 1).key("matchups").beginArray();
+            for (const Matchup* matchup : league->getSchedule()) {
+                writeMatchup(json, matchup);
+            }
+            json.endArray();
+        } else if (what == "players") {
+            long long limit = 10;
+            if (args.size() > 2 && (!parseInt(args[2], limit) || limit < 0)) {
+                return fail(json, "invalid player count");
+            }
+            auto top = makeTopK<const Player*>(static_cast<size_t>(limit), [](const Player* a, const Player* b) {
+                return a->getFantasyPoints() > b->getFantasyPoints();
+            });
+            for (int i = 0; i < league->getTeamCount(); ++i) {
+                for (const Player* player : league->getTeam(i)->getRoster()) {
+                    top.push(player);
+                }
+            }
+            league->getAvailablePlayers().forEach([&top](const Player* player) { top.push(player); });
+            json.key("players").beginArray();
+            for (const Player* player : top.sorted()) {
+                writePlayer(json, player);
+            }
+            json.endArray();
+        } else if (what == "available") {
+            json.key("players").beginArray();
+            auto write = [&json](const Player* player) { writePlayer(json, player); };
+            if (args.size() > 2) {
+                bool found = false;
+                for (int p = 0; p < POSITION_COUNT; ++p) {
+                    if (args[2] == positionToString(static_cast<Position>(p))) {
+                        league->getAvailablePlayers().forEach(static_cast<Position>(p), write);
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    json.endArray();
+                    return fail(json, "unknown position \"" + args[2] + "\"");
+                }
+            } else {
+                league->getAvailablePlayers().forEach(write);
+            }
+            json.endArray();
+        } else if (what == "schedule") {
+            const SeasonSchedule& plan = league->seasonSchedule();
+            json.key("weeks").beginArray();
+            for (int w = 0; w < plan.getWeekCount(); ++w) {
+                json.beginArray();
+                for (const SeasonSchedule::Game& game : plan.week(w)) {
+                    json.beginObject()
+                        .field("home", league->getTeam(game.home)->getName())
+                        .field("away", league->getTeam(game.away)->getName())
+                        .endObject();
+                }
+                json.endArray();
+            }
+            json.endArray();
+        } else if (what == "leaders") {
+            int from = 0, to = 0;
+            long long limit = 10;
+            if (args.size() < 4 || args.size() > 5 || !parseInt(args[2], from) || !parseInt(args[3], to)
+                || (args.size() == 5 && (!parseInt(args[4], limit) || limit < 0))) {
+                return fail(json, "usage: report leaders <from week> <to week> [n]");
+            }
+            const StatHistory& history = league->getHistory();
+            json.field("from", from).field("to", to).key("players").beginArray();
+            for (const StatHistory::Leader& leader : history.top(static_cast<size_t>(limit), from, to)) {
+                int games = 0;
+                history.stats(leader.player->getId(), from, to, &games);
+                json.beginObject()
+                    .field("id", leader.player->getId())
+                    .field("name", leader.player->getName())
+                    .field("position", positionToString(leader.player->getPosition()))
+                    .field("team", leader.player->getTeam())
+                    .field("games", games)
+                    .field("points", leader.points)
+                    .endObject();
+            }
+            json.endArray();
+        } else {
+            return fail(json, "unknown report \"" + what + "\"");
+        }
+        return true;
+    }
+    
+    bool dispatch(const std::vector<std::string>& args, JsonWriter& json) {
+        const std::string& cmd = args[0];
+        long long number = 0;
+        
+        if (cmd == "seed") {
+            if (args.size() != 2 || !parseInt(args[1], number)) {
+                return fail(json, "usage: seed <n>");
+            }
+            hasSeed = true;
+            seed = static_cast<uint64_t>(number);
+            league->setSeed(seed);
+        } else if (cmd == "players") {
+            if (args.size() != 2) {
+                return fail(json, "usage: players <file>");
+            }
+            League* loaded = new League("Fantasy Football League", 8, 10, 5, false);
+            PlayerImporter::Result result = loaded->importPlayers(args[1]);
+            if (!result.error.empty()) {
+                delete loaded;
+                return fail(json, result.error);
+            }
+            adopt(loaded);
+            json.field("imported", result.imported).field("skipped", result.skipped);
+        } else if (cmd == "load") {
+            if (args.size() != 2) {
+                return fail(json, "usage: load <file>");
+            }
+            MappedSnapshot snapshot(args[1]);
+            League* loaded = League::fromSnapshot(snapshot);
+            if (!loaded) {
+                return fail(json, snapshot.getError());
+            }
+            hasSeed = false;
+            adopt(loaded);
+        } else if (cmd == "save") {
+            if (args.size() != 2) {
+                return fail(json, "usage: save <file>");
+            }
+            if (!league->saveSnapshot(args[1])) {
+                std::string message = takeMessages();
+                return fail(json, message.empty() ? "cannot write " + args[1] : message);
+            }
+        } else if (cmd == "journal") {
+            if (args.size() != 2) {
+                return fail(json, "usage: journal <file>|off");
+            }
+            if (args[1] == "off") {
+                league->stopJournal();
+                journalPath.clear();
+            } else {
+                // Pick up where a previous run left off, or start journaling this league
+                std::string error;
+                size_t replayed = 0;
+                League* recovered = League::recover(args[1], error, replayed);
+                if (!recovered && std::ifstream(args[1]).good()) {
+                    return fail(json, error);
+                }
+                journalPath = args[1];
+                if (recovered) {
+                    hasSeed = false;
+                    adopt(recovered);
+                } else if (!league->startJournal(journalPath)) {
+                    journalPath.clear();
+                }
+                if (journalPath.empty()) {
+                    return fail(json, takeMessages());
+                }
+                json.field("recovered", recovered != nullptr).field("replayed", replayed);
+            }
+        } else if (cmd == "checkpoint") {
+            if (!league->isJournaled()) {
+                return fail(json, "no journal is open");
+            }
+            if (!league->checkpoint()) {
+                return fail(json, takeMessages());
+            }
+        } else if (cmd == "register") {
+            if (args.size() != 3) {
+                return fail(json, "usage: register <team> <owner>");
+            }
+            if (!league->registerTeam(args[1], args[2])) {
+                return fail(json, takeMessages());
+            }
+        } else if (cmd == "draft" || cmd == "drop") {
+            int id = 0;
+            if (args.size() != 3 || !parseInt(args[2], id)) {
+                return fail(json, "usage: " + cmd + " <team> <player id>");
+            }
+            Team* team = requireTeam(args[1], json);
+            if (!team) {
+                return false;
+            }
+            bool ok = cmd == "draft" ? league->draftPlayer(team, id) : league->dropPlayer(team, id);
+            if (!ok) {
+                return fail(json, takeMessages());
+            }
+            json.field("rosterSize", team->getRosterSize());
+        } else if (cmd == "add" || cmd == "claim") {
+            int id = 0, drop = 0;
+            if (args.size() < 3 || args.size() > 4 || !parseInt(args[2], id)
+                || (args.size() == 4 && !parseInt(args[3], drop))) {
+                return fail(json, "usage: " + cmd + " <team> <player id> [drop id]");
+            }
+            Team* team = requireTeam(args[1], json);
+            if (!team) {
+                return false;
+            }
+            bool ok = cmd == "add" ? league->addFreeAgent(team, id, drop) : league->submitWaiverClaim(team, id, drop);
+            if (!ok) {
+                return fail(json, takeMessages());
+            }
+            json.field("rosterSize", team->getRosterSize());
+        } else if (cmd == "waivers") {
+            size_t awarded = league->processWaivers();
+            json.field("awarded", awarded).key("order").beginArray();
+            for (const Team* team : league->getWaiverOrder()) {
+                json.value(team->getName());
+            }
+            json.endArray();
+        } else if (cmd == "trade" || cmd == "analyze") {
+            std::vector<int> firstGives, secondGives;
+            if (args.size() != 5 || !parseIds(args[2], firstGives) || !parseIds(args[4], secondGives)) {
+                return fail(json, "usage: " + cmd + " <team> <ids> <team> <ids>");
+            }
+            Team* first = requireTeam(args[1], json);
+            Team* second = first ? requireTeam(args[3], json) : nullptr;
+            if (!second) {
+                return false;
+            }
+            if (cmd == "trade") {
+                if (!league->tradePlayers(first, firstGives, second, secondGives)) {
+                    return fail(json, takeMessages());
+                }
+            } else {
+                TradeAnalyzer analyzer(*league);
+                TradeAnalyzer::Evaluation evaluation = analyzer.evaluate(first, firstGives, second, secondGives);
+                if (!evaluation.valid) {
+                    return fail(json, "invalid trade");
+                }
+                writeSide(json, "first", first, evaluation.first);
+                writeSide(json, "second", second, evaluation.second);
+            }
+        } else if (cmd == "suggest") {
+            long long limit = 5;
+            if (args.size() < 2 || args.size() > 3 || (args.size() == 3 && (!parseInt(args[2], limit) || limit < 0))) {
+                return fail(json, "usage: suggest <team> [n]");
+            }
+            Team* team = requireTeam(args[1], json);
+            if (!team) {
+                return false;
+            }
+            TradeAnalyzer analyzer(*league);
+            json.key("trades").beginArray();
+            for (const TradeAnalyzer::Suggestion& suggestion : analyzer.suggest(team, static_cast<size_t>(limit))) {
+                json.beginObject()
+                    .field("partner", suggestion.partner->getName())
+                    .field("gives", suggestion.gives->getId())
+                    .field("receives", suggestion.receives->getId());
+                writeSide(json, "first", team, suggestion.evaluation.first);
+                writeSide(json, "second", suggestion.partner, suggestion.evaluation.second);
+                json.endObject();
+            }
+            json.endArray();
+        } else if (cmd == "lineup") {
+            if (args.size() < 2) {
+                return fail(json, "usage: lineup <team> <player id>...");
+            }
+            Team* team = requireTeam(args[1], json);
+            if (!team) {
+                return false;
+            }
+            std::vector<int> ids(args.size() - 2);
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (!parseInt(args[i], ids[i - 2])) {
+                    return fail(json, "invalid player id \"" + args[i] + "\"");
+                }
+            }
+            if (!league->setTeamLineup(team, ids)) {
+                return fail(json, takeMessages());
+            }
+        } else if (cmd == "autodraft") {
+            if (args.size() != 1) {
+                return fail(json, "usage: autodraft");
+            }
+            AutoDraft draft(*league);
+            std::vector<AutoDraft::Pick> picks = draft.run();
+            json.key("picks").beginArray();
+            for (const AutoDraft::Pick& pick : picks) {
+                json.beginObject()
+                    .field("round", pick.round)
+                    .field("team", pick.team->getName())
+                    .field("player", pick.player->getId())
+                    .field("value", pick.value)
+                    .endObject();
+            }
+            json.endArray();
+        } else if (cmd == "optimize") {
+            if (args.size() < 2 || args.size() > 3 || (args.size() == 3 && args[2] != "points" && args[2] != "win")) {
+                return fail(json, "usage: optimize <team>|--all [points|win]");
+            }
+            if (args[1] == "--all") {
+                json.field("optimized", league->optimizeAllLineups());
+            } else {
+                Team* team = requireTeam(args[1], json);
+                if (!team) {
+                    return false;
+                }
+                if (!league->optimizeLineup(team, args.size() == 3 && args[2] == "win")) {
+                    return fail(json, takeMessages());
+                }
+                json.key("lineup").beginArray();
+                for (const Player* player : team->getActiveLineup()) {
+                    json.value(player->getId());
+                }
+                json.endArray();
+            }
+        } else if (cmd == "generate") {
+            if (!league->generateMatchups()) {
+                return fail(json, takeMessages());
+            }
+            json.field("week", league->getCurrentWeek()).key("matchups").beginArray();
+            for (const Matchup* matchup : league->getSchedule()) {
+                writeMatchup(json, matchup);
+            }
+            json.endArray();
+        } else if (cmd == "simulate") {
+            int week = league->getCurrentWeek();
+            if (!league->simulateWeek()) {
+                return fail(json, takeMessages());
+            }
+            json.field("week", week).key("matchups").beginArray();
+            for (const Matchup* matchup : league->getSchedule()) {
+                writeMatchup(json, matchup);
+            }
+            json.endArray();
+        } else if (cmd == "report") {
+            if (!report(args, json)) {
+                return false;
+            }
+        } else if (cmd == "export") {
+            if (args.size() != 4) {
+                return fail(json, "usage: export standings|teams|players|available|week text|csv|json <file>");
+            }
+            std::unique_ptr<ReportWriter> writer = ReportWriter::create(args[2]);
+            if (!writer) {
+                return fail(json, "unknown format \"" + args[2] + "\"");
+            }
+            const std::string& what = args[1];
+            if (what == "standings") {
+                league->displayStandings(*writer);
+            } else if (what == "teams") {
+                league->displayTeams(*writer);
+            } else if (what == "players") {
+                league->displayPlayerStatistics(*writer);
+            } else if (what == "available") {
+                league->displayAvailablePlayers(*writer);
+            } else if (what == "week") {
+                league->weeklyReport(*writer);
+            } else {
+                return fail(json, "unknown report \"" + what + "\"");
+            }
+            std::ofstream file(args[3], std::ios::binary);
+            size_t bytes = writer->getBuffer().size();
+            writer->flush(file);
+            if (!file) {
+                return fail(json, "cannot write " + args[3]);
+            }
+            json.field("bytes", bytes);
+        } else if (cmd == "season") {
+            int weeks = 0, playoffs = 0, divisions = 1, divisionWeeks = 0;
+            if ((args.size() != 3 && args.size() != 5) || !parseInt(args[1], weeks) || !parseInt(args[2], playoffs)
+                || weeks < 1 || playoffs < 1
+                || (args.size() == 5 && (!parseInt(args[3], divisions) || !parseInt(args[4], divisionWeeks)
+                                         || divisions < 1 || divisionWeeks < 0))) {
+                return fail(json, "usage: season <weeks> <playoff teams> [<divisions> <division weeks>]");
+            }
+            league->setSeasonFormat(weeks, playoffs);
+            league->setDivisionFormat(divisions, divisionWeeks);
+        } else if (cmd == "scoring") {
+            ScoringRules rules = league->getScoringRules();
+            if (args.size() == 2) {
+                if (!ScoringRules::preset(args[1], rules)) {
+                    return fail(json, "unknown scoring rules \"" + args[1] + "\"");
+                }
+            } else if (args.size() == 3 || args.size() == 4) {
+                int stat = 0;
+                while (stat < STAT_COUNT && args[1] != statName(static_cast<Stat>(stat))) {
+                    stat++;
+                }
+                char* end = nullptr;
+                double weight = std::strtod(args[2].c_str(), &end);
+                if (stat == STAT_COUNT || stat == STAT_POINTS_ALLOWED || args[2].empty() || *end != '\0') {
+                    return fail(json, "usage: scoring <stat> <weight> [pos]");
+                }
+                if (args.size() == 4) {
+                    int pos = 0;
+                    while (pos < POSITION_COUNT && args[3] != positionToString(static_cast<Position>(pos))) {
+                        pos++;
+                    }
+                    if (pos == POSITION_COUNT) {
+                        return fail(json, "unknown position \"" + args[3] + "\"");
+                    }
+                    rules.setWeight(static_cast<Stat>(stat), static_cast<Position>(pos), weight);
+                } else {
+                    rules.setWeight(static_cast<Stat>(stat), weight);
+                }
+                rules.setName("custom");
+            } else {
+                return fail(json, "usage: scoring standard|half-ppr|ppr|<stat> <weight> [pos]");
+            }
+            league->setScoringRules(rules);
+            json.field("rules", rules.getName());
+        } else if (cmd == "rescore") {
+            ScoringRules rules;
+            long long limit = 10;
+            if (args.size() < 2 || args.size() > 3 || !ScoringRules::preset(args[1], rules)
+                || (args.size() == 3 && (!parseInt(args[2], limit) || limit < 0))) {
+                return fail(json, "usage: rescore standard|half-ppr|ppr [n]");
+            }
+            const StatHistory& history = league->getHistory();
+            auto top = makeTopK<StatHistory::Leader>(static_cast<size_t>(limit),
+                [](const StatHistory::Leader& a, const StatHistory::Leader& b) { return a.points > b.points; });
+            for (const StatHistory::Leader& leader : history.rescore(rules)) {
+                top.push(leader);
+            }
+            json.field("rules", rules.getName()).key("players").beginArray();
+            for (const StatHistory::Leader& leader : top.sorted()) {
+                json.beginObject()
+                    .field("id", leader.player->getId())
+                    .field("name", leader.player->getName())
+                    .field("position", positionToString(leader.player->getPosition()))
+                    .field("points", history.points(leader.player->getId(), history.getFirstWeek(), history.getLastWeek()))
+                    .field("rescored", leader.points)
+                    .endObject();
             }
+            json.endArray();
+        } else if (cmd == "trace") {
+            if (args.size() == 2 && (args[1] == "on" || args[1] == "off")) {
+                Trace::enable(args[1] == "on");
+            } else if (args.size() == 2 && args[1] == "clear") {
+                Trace::clear();
+            } else if (args.size() == 3 && args[1] == "export") {
+                std::ofstream file(args[2], std::ios::binary);
+                Trace::exportChromeTrace(file);
+                if (!file) {
+                    return fail(json, "cannot write " + args[2]);
+                }
+            } else {
+                return fail(json, "usage: trace on|off|clear|export <file>");
+            }
+        } else if (cmd == "odds") {
+            if (args.size() != 2 || !parseInt(args[1], number) || number <= 0) {
+                return fail(json, "usage: odds <seasons>");
+            }
+            if (league->getTeamCount() < 2) {
+                return fail(json, "need at least 2 teams to simulate a season");
+            }
+            SeasonSnapshot snapshot = league->seasonSnapshot();
+            if (snapshot.missingLineup() >= 0) {
+                return fail(json, snapshot.teamNames[snapshot.missingLineup()] + " has no active lineup; set every lineup first");
+            }
+            uint64_t oddsSeed = league->isSeeded() ? Random::deriveSeed(league->getSeed(), league->getCurrentWeek())
+                                                   : Random::engine()();
+            SeasonSimulator simulator;
+            std::vector<TeamOdds> odds = simulator.run(snapshot, static_cast<size_t>(number), oddsSeed);
+            json.key("odds").beginArray();
+            for (const auto& team : odds) {
+                json.beginObject()
+                    .field("team", team.team)
+                    .key("playoffs").value(team.playoffProbability, 4)
+                    .key("title").value(team.championshipProbability, 4)
+                    .field("expectedWins", team.expectedWins)
+                    .endObject();
+            }
+            json.endArray();
+        } else {
+            return fail(json, "unknown command \"" + cmd + "\"");
         }
+        
+        // Acknowledge only what is durable; a write failure drops the league's journal
+        if (!journalPath.empty() && (!league->syncJournal() || !league->isJournaled())) {
+            journalPath.clear();
+            return fail(json, takeMessages());
+        }
+        json.field("ok", true);
+        return true;
+    }
+
+public:
+    explicit BatchRunner(std::ostream& output)
+        : league(nullptr), output(output), hasSeed(false), seed(0), failures(0) {
+        adopt(new League("Fantasy Football League", 8, 10, 5));
     }
     
-    // Getters
-    int getCurrentWeek() const { return currentWeek; }
-    int getTeamCount() const { return teams.size(); }
-    int getMaxTeams() const { return maxTeams; }
-    int getRosterSize() const { return rosterSize; }
-    int getLineupSize() const { return lineupSize; }
+    ~BatchRunner() {
+        delete league;
+    }
     
-    // Get team by index
-    Team* getTeam(int index) {
-        if (index >= 0 && index < static_cast<int>(teams.size())) {
-            return teams[index];
-        }
-        return nullptr;
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+    
+    size_t getFailures() const { return failures; }
+    
+    // Parse a whole argument as an integer; main checks the command-line options with it too
+    static bool parseInt(const std::string& text, long long& number) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
     }
     
-    // Get available player by ID
-    Player* getAvailablePlayerById(int id) {
-        for (auto& player : availablePlayers) {
-            if (player->getId() == id) {
-                return player;
-            }
+    // Same for an int (IDs, weeks, ...); values outside its range are malformed too
+    static bool parseInt(const std::string& text, int& number) {
+        long long wide = 0;
+        if (!parseInt(text, wide) || wide < std::numeric_limits<int>::min() || wide > std::numeric_limits<int>::max()) {
+            return false;
         }
-        return nullptr;
+        number = static_cast<int>(wide);
+        return true;
     }
     
-    // Get player by ID from all players (teams and available)
-    Player* getPlayerById(int id) {
-        // First check available players
-        for (auto& player : availablePlayers) {
-            if (player->getId() == id) {
-                return player;
+    // Split a command line into arguments, honoring double quotes
+    static std::vector<std::string> tokenize(const std::string& line) {
+        std::vector<std::string> args;
+        size_t i = 0;
+        while (i < line.size()) {
+            while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) i++;
+            if (i >= line.size()) break;
+            std::string arg;
+            if (line[i] == '"') {
+                for (i++; i < line.size() && line[i] != '"'; ++i) {
+                    if (line[i] == '\\' && i + 1 < line.size()) i++;
+                    arg += line[i];
+                }
+                i++;
+            } else {
+                while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) arg += line[i++];
             }
+            args.push_back(arg);
         }
-        
-        // Then check team rosters
-        for (auto& team : teams) {
-            Player* player = team->getPlayerById(id);
-            if (player) {
-                return player;
-            }
+        return args;
+    }
+    
+    // Run one command and write its JSON response line
+    bool execute(const std::vector<std::string>& args) {
+        response.clear();
+        JsonWriter json(response);
+        json.beginObject().field("cmd", args[0]);
+        messages.str(std::string());
+        bool ok = dispatch(args, json);
+        json.endObject();
+        response += '\n';
+        output.write(response.data(), static_cast<std::streamsize>(response.size()));
+        if (!ok) {
+            failures++;
         }
-        
-        return nullptr;
+        return ok;
     }
     
-    // Check if all teams have full rosters
-    bool allTeamsHaveFullRosters() const {
-        for (const auto& team : teams) {
-            if (team->getRosterSize() < rosterSize) {
-                return false;
+    // Run every command in a stream; returns the number of failed commands
+    size_t run(std::istream& input) {
+        std::string line;
+        while (std::getline(input, line)) {
+            std::vector<std::string> args = tokenize(line);
+            if (args.empty() || args[0][0] == '#') {
+                continue;
             }
+            execute(args);
         }
-        return !teams.empty(); // Only return true if there are teams and they all have full rosters
+        output.flush();
+        return failures;
     }
 };
 
@@ -1045,12 +7553,27 @@ public:
 class SportsManagerApp {
 private:
     League* league;
+    std::string journalPath;    // leagues loaded later are journaled here too
+    bool hasSeed;
+    uint64_t seed;              // reapplied to leagues loaded later
+    
+    // Replace the league, carrying the seed and the journal over to the new one
+    void adopt(League* replacement) {
+        delete league;
+        league = replacement;
+        if (hasSeed) {
+            league->setSeed(seed);
+        }
+        if (!journalPath.empty() && !league->startJournal(journalPath)) {
+            journalPath.clear();
+        }
+    }
     
     // Display main menu
     void displayMainMenu() const {
         Utility::clearScreen();
         Utility::displayTitle("SPORTS TEAM MANAGER");
-        std::cout << "WEEK " << league->getCurrentWeek() << std::endl;
+        std::cout << "WEEK " << league->getCurrentWeek() << '\n';
         std::cout << "1. Register Team\n";
         std::cout << "2. View Teams\n";
         std::cout << "3. Draft Players\n";
@@ -1062,6 +7585,9 @@ private:
         std::cout << "9. View Standings\n";
         std::cout << "10. View Player Statistics\n";
         std::cout << "11. Weekly Report\n";
+        std::cout << "12. Season Odds\n";
+        std::cout << "13. Save League\n";
+        std::cout << "14. Load League\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter choice: ";
     }
@@ -1138,100 +7664,138 @@ private:
     
     // Draft players menu
     void draftPlayersMenu() {
-        Utility::clearScreen();
-        Utility::displayTitle("DRAFT PLAYERS");
-        
-        if (league->getTeamCount() == 0) {
-            std::cout << "No teams registered yet.\n";
-            std::cout << "Press Enter to continue...";
-            std::cin.get();
-            return;
-        }
-        
-        if (league->allTeamsHaveFullRosters()) {
-            std::cout << "All teams have full rosters.\n";
-            std::cout << "Press Enter to continue...";
-            std::cin.get();
-            return;
-        }
-        
-        // Select team
-        league->displayTeams();
-        std::cout << "\nSelect team to draft for (enter team number): ";
-        int teamIndex = Utility::getIntInput(1, league->getTeamCount()) - 1;
-        
-        Team* team = league->getTeam(teamIndex);
-        if (!team) {
-            std::cout << "Invalid team selection.\n";
-            std::cout << "Press Enter to continue...";
-            std::cin.get();
-            return;
-        }
-        
-        if (team->getRosterSize() >= league->getRosterSize()) {
-            std::cout << team->getName() << " already has a full roster.\n";
+        // Repeats until the chosen team's roster is full or the user cancels
+        while (true) {
+            Utility::clearScreen();
+            Utility::displayTitle("DRAFT PLAYERS");
+            
+            if (league->getTeamCount() == 0) {
+                std::cout << "No teams registered yet.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                return;
+            }
+            
+            if (league->allTeamsHaveFullRosters()) {
+                std::cout << "All teams have full rosters.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                return;
+            }
+            
+            // Select team
+            league->displayTeams();
+            std::cout << "\nSelect team to draft for (enter team number, 0 to auto-draft every team): ";
+            int teamIndex = Utility::getIntInput(0, league->getTeamCount()) - 1;
+            
+            if (teamIndex < 0) {
+                autoDraft();
+                return;
+            }
+            
+            Team* team = league->getTeam(teamIndex);
+            if (!team) {
+                std::cout << "Invalid team selection.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                return;
+            }
+            
+            if (team->getRosterSize() >= league->getRosterSize()) {
+                std::cout << team->getName() << " already has a full roster.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                return;
+            }
+            
+            Utility::clearScreen();
+            std::cout << "Drafting for: " << team->getName() << " (" << team->getRosterSize() << "/" << league->getRosterSize() << " players)\n\n";
+            
+            // Display available players by position
+            std::cout << "Select position to view:\n";
+            std::cout << "1. Quarterbacks (QB)\n";
+            std::cout << "2. Running Backs (RB)\n";
+            std::cout << "3. Wide Receivers (WR)\n";
+            std::cout << "4. Tight Ends (TE)\n";
+            std::cout << "5. Kickers (K)\n";
+            std::cout << "6. Defenses (DEF)\n";
+            std::cout << "7. All Available Players\n";
+            std::cout << "Enter choice: ";
+            
+            int posChoice = Utility::getIntInput(1, 7);
+            
+            Utility::clearScreen();
+            if (posChoice == 7) {
+                league->displayAvailablePlayers();
+            } else {
+                Position position;
+                switch (posChoice) {
+                    case 1: position = Position::QUARTERBACK; break;
+                    case 2: position = Position::RUNNING_BACK; break;
+                    case 3: position = Position::WIDE_RECEIVER; break;
+                    case 4: position = Position::TIGHT_END; break;
+                    case 5: position = Position::KICKER; break;
+                    case 6: position = Position::DEFENSE; break;
+                    default: position = Position::QUARTERBACK; break;
+                }
+                league->displayPlayersByPosition(position);
+            }
+            
+            std::cout << "\nEnter Player ID to draft (0 to cancel): ";
+            int playerId = Utility::getIntInput(0, league->getMaxPlayerId());
+            
+            if (playerId == 0) {
+                return;
+            }
+            
+            Player* player = league->getAvailablePlayerById(playerId);
+            if (!player) {
+                std::cout << "Invalid player ID or player already drafted.\n";
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
+                return;
+            }
+            
+            league->draftPlayer(team, playerId);
+            
             std::cout << "Press Enter to continue...";
             std::cin.get();
-            return;
-        }
-        
-        Utility::clearScreen();
-        std::cout << "Drafting for: " << team->getName() << " (" << team->getRosterSize() << "/" << league->getRosterSize() << " players)\n\n";
-        
-        // Display available players by position
-        std::cout << "Select position to view:\n";
-        std::cout << "1. Quarterbacks (QB)\n";
-        std::cout << "2. Running Backs (RB)\n";
-        std::cout << "3. Wide Receivers (WR)\n";
-        std::cout << "4. Tight Ends (TE)\n";
-        std::cout << "5. Kickers (K)\n";
-        std::cout << "6. Defenses (DEF)\n";
-        std::cout << "7. All Available Players\n";
-        std::cout << "Enter choice: ";
-        
-        int posChoice = Utility::getIntInput(1, 7);
-        
-        Utility::clearScreen();
-        if (posChoice == 7) {
-            league->displayAvailablePlayers();
-        } else {
-            Position position;
-            switch (posChoice) {
-                case 1: position = Position::QUARTERBACK; break;
-                case 2: position = Position::RUNNING_BACK; break;
-                case 3: position = Position::WIDE_RECEIVER; break;
-                case 4: position = Position::TIGHT_END; break;
-                case 5: position = Position::KICKER; break;
-                case 6: position = Position::DEFENSE; break;
-                default: position = Position::QUARTERBACK; break;
+            
+            // Keep drafting until this team's roster is full
+            if (team->getRosterSize() >= league->getRosterSize()) {
+                return;
             }
-            league->displayPlayersByPosition(position);
-        }
-        
-        std::cout << "\nEnter Player ID to draft (0 to cancel): ";
-        int playerId = Utility::getIntInput(0, 100);
-        
-        if (playerId == 0) {
-            return;
         }
-        
-        Player* player = league->getAvailablePlayerById(playerId);
-        if (!player) {
-            std::cout << "Invalid player ID or player already drafted.\n";
-            std::cout << "Press Enter to continue...";
-            std::cin.get();
-            return;
+    }
+    
+    // Fill every roster with a snake draft by value over replacement
+    void autoDraft() {
+        Utility::clearScreen();
+        Utility::displayTitle("AUTO DRAFT");
+        
+        AutoDraft draft(*league);
+        std::ostringstream picks;
+        league->setMessageStream(picks);
+        std::vector<AutoDraft::Pick> made = draft.run();
+        league->setMessageStream(std::cout);
+        
+        TextReportWriter& report = TextReportWriter::console();
+        report.beginTable({}, {{"Rd", 3, true}, {"Team", 20, false}, {"Player", 20, false},
+                               {"Pos", 5, false}, {"VOR", 6, true}});
+        for (const AutoDraft::Pick& pick : made) {
+            report.cell(pick.round);
+            report.cell(pick.team->getName());
+            report.cell(pick.player->getName());
+            report.cell(positionToString(pick.player->getPosition()));
+            report.cell(pick.value);
+            report.endRow();
         }
-        
-        league->draftPlayer(team, playerId);
+        report.endTable();
+        report.note(std::to_string(made.size()) + " players drafted.");
+        report.flush(std::cout);
         
         std::cout << "Press Enter to continue...";
         std::cin.get();
-        
-        // Loop back to this menu if roster isn't full
-        if (team->getRosterSize() < league->getRosterSize()) {
-            draftPlayersMenu();
-        }
     }
     
     // Set lineup menu
@@ -1281,12 +7845,24 @@ private:
         std::cout << "Team roster:\n";
         team->displayRoster();
         
+        std::cout << "\n1. Pick players manually\n";
+        std::cout << "2. Best projected lineup\n";
+        std::cout << "3. Best chance to win this week's matchup\n";
+        std::cout << "Enter choice: ";
+        int mode = Utility::getIntInput(1, 3);
+        if (mode != 1) {
+            league->optimizeLineup(team, mode == 3);
+            std::cout << "Press Enter to continue...";
+            std::cin.get();
+            return;
+        }
+        
         std::vector<int> lineupIds;
         std::cout << "\nSelect " << league->getLineupSize() << " players for your lineup:\n";
         
         for (int i = 0; i < league->getLineupSize(); ++i) {
             std::cout << "Enter Player #" << (i + 1) << " ID: ";
-            int playerId = Utility::getIntInput(1, 100);
+            int playerId = Utility::getIntInput(1, league->getMaxPlayerId());
             
             Player* player = team->getPlayerById(playerId);
             if (!player) {
@@ -1353,8 +7929,8 @@ private:
         Utility::clearScreen();
         Utility::displayTitle("PLAYER DETAILS");
         
-        std::cout << "Enter Player ID (1-38): ";
-        int playerId = Utility::getIntInput(1, 38);
+        std::cout << "Enter Player ID (1-" << league->getMaxPlayerId() << "): ";
+        int playerId = Utility::getIntInput(1, league->getMaxPlayerId());
         
         Player* player = league->getPlayerById(playerId);
         if (!player) {
@@ -1445,9 +8021,91 @@ private:
         std::cout << "\nPress Enter to continue...";
         std::cin.get();
     }
+    
+    // Season odds menu
+    void seasonOddsMenu() {
+        Utility::clearScreen();
+        Utility::displayTitle("SEASON ODDS");
+        
+        if (league->getTeamCount() < 2) {
+            std::cout << "Need at least 2 teams to simulate a season.\n";
+            std::cout << "Press Enter to continue...";
+            std::cin.get();
+            return;
+        }
+        
+        SeasonSnapshot snapshot = league->seasonSnapshot();
+        if (snapshot.missingLineup() >= 0) {
+            std::cout << snapshot.teamNames[snapshot.missingLineup()] << " has no active lineup; set every lineup first.\n";
+            std::cout << "Press Enter to continue...";
+            std::cin.get();
+            return;
+        }
+        
+        std::cout << "Number of seasons to simulate (1000-10000000): ";
+        int seasons = Utility::getIntInput(1000, 10000000);
+        
+        uint64_t seed = league->isSeeded() ? Random::deriveSeed(league->getSeed(), league->getCurrentWeek())
+                                           : Random::engine()();
+        SeasonSimulator simulator;
+        std::vector<TeamOdds> odds = simulator.run(snapshot, seasons, seed);
+        std::sort(odds.begin(), odds.end(), [](const TeamOdds& a, const TeamOdds& b) {
+            return a.championshipProbability > b.championshipProbability;
+        });
+        
+        TextReportWriter& report = TextReportWriter::console();
+        report.beginTable({}, {{"Team", 20, false}, {"Playoffs %", 10, true}, {"Title %", 10, true},
+                               {"Exp. W", 8, true}});
+        for (const auto& team : odds) {
+            report.cell(team.team);
+            report.cell(team.playoffProbability * 100.0);
+            report.cell(team.championshipProbability * 100.0);
+            report.cell(team.expectedWins);
+            report.endRow();
+        }
+        report.endTable();
+        report.flush(std::cout);
+        
+        std::cout << "\nPress Enter to continue...";
+        std::cin.get();
+    }
+    
+    // Save league menu
+    void saveLeagueMenu() {
+        Utility::clearScreen();
+        Utility::displayTitle("SAVE LEAGUE");
+        
+        std::cout << "Enter snapshot file name: ";
+        std::string path = Utility::getStringInput();
+        
+        if (league->saveSnapshot(path)) {
+            std::cout << "League saved to " << path << ".\n";
+        } else {
+            std::cout << "Failed to write " << path << ".\n";
+        }
+        
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+    }
+    
+    // Load league menu
+    void loadLeagueMenu() {
+        Utility::clearScreen();
+        Utility::displayTitle("LOAD LEAGUE");
+        
+        std::cout << "Enter snapshot file name: ";
+        std::string path = Utility::getStringInput();
+        
+        if (loadLeague(path)) {
+            std::cout << "League loaded from " << path << ".\n";
+        }
+        
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+    }
 
 public:
-    SportsManagerApp() {
+    SportsManagerApp() : hasSeed(false), seed(0) {
         // Create a league with 8 max teams, 10 roster spots, 5 lineup spots
         league = new League("Fantasy Football League", 8, 10, 5);
     }
@@ -1456,12 +8114,70 @@ public:
         delete league;
     }
     
+    // Replace the current league with one restored from a snapshot file
+    bool loadLeague(const std::string& path) {
+        MappedSnapshot snapshot(path);
+        League* loaded = League::fromSnapshot(snapshot);
+        if (!loaded) {
+            std::cout << "Cannot load " << path << ": " << snapshot.getError() << ".\n";
+            return false;
+        }
+        adopt(loaded);
+        return true;
+    }
+    
+    // Start a fresh league whose player pool comes from a CSV or JSON file
+    bool loadPlayers(const std::string& path) {
+        League* loaded = new League("Fantasy Football League", 8, 10, 5, false);
+        PlayerImporter::Result result = loaded->importPlayers(path);
+        if (!result.error.empty() || result.imported == 0) {
+            std::cout << "Cannot import players from " << path << ": "
+                      << (result.error.empty() ? "no valid rows" : result.error) << ".\n";
+            delete loaded;
+            return false;
+        }
+        std::cout << "Imported " << result.imported << " players";
+        if (result.skipped > 0) {
+            std::cout << " (" << result.skipped << " rows skipped)";
+        }
+        std::cout << ".\n";
+        adopt(loaded);
+        return true;
+    }
+    
+    // Journal every change to disk at path. If a journaled league is already there (the
+    // last session ended or crashed), it is recovered and replaces the current one.
+    bool openJournal(const std::string& path) {
+        std::string error;
+        size_t replayed = 0;
+        League* recovered = League::recover(path, error, replayed);
+        if (!recovered && std::ifstream(path).good()) {
+            std::cout << "Cannot recover " << path << ": " << error << ".\n";
+            return false;
+        }
+        journalPath = path;
+        if (recovered) {
+            adopt(recovered);
+            std::cout << "Recovered league from " << path << " (" << replayed << " transactions replayed).\n";
+        } else if (!league->startJournal(path)) {
+            journalPath.clear();
+        }
+        return !journalPath.empty();
+    }
+    
+    // Make every simulated week reproducible from the given seed
+    void setSeed(uint64_t value) {
+        hasSeed = true;
+        seed = value;
+        league->setSeed(seed);
+    }
+    
     void run() {
         bool running = true;
         
         while (running) {
             displayMainMenu();
-            int choice = Utility::getIntInput(0, 11);
+            int choice = Utility::getIntInput(0, 14);
             
             switch (choice) {
                 case 0: running = false; break;
@@ -1476,6 +8192,16 @@ public:
                 case 9: viewStandingsMenu(); break;
                 case 10: viewPlayerStatisticsMenu(); break;
                 case 11: weeklyReportMenu(); break;
+                case 12: seasonOddsMenu(); break;
+                case 13: saveLeagueMenu(); break;
+                case 14: loadLeagueMenu(); break;
+            }
+            
+            // Each change is on disk before the next menu; a failed write drops the journal
+            if (!journalPath.empty() && (!league->syncJournal() || !league->isJournaled())) {
+                journalPath.clear();
+                std::cout << "Press Enter to continue...";
+                std::cin.get();
             }
         }
         
@@ -1483,8 +8209,94 @@ public:
     }
 };
 
-int main() {
+#ifndef SPORTS_MANAGER_NO_MAIN
+int main(int argc, char* argv[]) {
+    // Startup options, kept as commands so both modes apply them in order
+    std::vector<std::vector<std::string>> setup;
+    bool batch = false;
+    std::string script;
+    std::string traceFile;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            setup.push_back({"seed", argv[++i]});
+        } else if (arg == "--players" && i + 1 < argc) {
+            setup.push_back({"players", argv[++i]});
+        } else if (arg == "--load" && i + 1 < argc) {
+            setup.push_back({"load", argv[++i]});
+        } else if (arg == "--journal" && i + 1 < argc) {
+            setup.push_back({"journal", argv[++i]});
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                script = argv[++i];
+            }
+        }
+    }
+    
+    // Record phase timings and write them out however main returns
+    struct TraceOutput {
+        std::string file;
+        ~TraceOutput() {
+            if (file.empty()) {
+                return;
+            }
+            std::ofstream out(file);
+            Trace::exportChromeTrace(out);
+            TextReportWriter summary;
+            Trace::writeSummary(summary);
+            summary.flush(std::cerr);
+        }
+    } traceOutput{traceFile};
+    Trace::enable(!traceFile.empty());
+    
+    if (batch) {
+        std::ios::sync_with_stdio(false);
+        BatchRunner runner(std::cout);
+        for (const auto& command : setup) {
+            if (!runner.execute(command)) {
+                return 1;
+            }
+        }
+        if (script.empty()) {
+            runner.run(std::cin);
+        } else {
+            std::ifstream input(script);
+            if (!input) {
+                std::cerr << "Cannot open " << script << std::endl;
+                return 1;
+            }
+            runner.run(input);
+        }
+        return runner.getFailures() == 0 ? 0 : 1;
+    }
+    
     SportsManagerApp app;
+    for (const auto& command : setup) {
+        if (command[0] == "seed") {
+            long long number = 0;
+            if (!BatchRunner::parseInt(command[1], number)) {
+                std::cout << "usage: --seed <n>\n";
+                return 1;
+            }
+            app.setSeed(static_cast<uint64_t>(number));
+        } else if (command[0] == "players") {
+            if (!app.loadPlayers(command[1])) {
+                return 1;
+            }
+        } else if (command[0] == "journal") {
+            if (!app.openJournal(command[1])) {
+                return 1;
+            }
+        } else if (!app.loadLeague(command[1])) {
+            return 1;
+        }
+    }
+    
     app.run();
     return 0;
-}
\ No newline at end of file
+}
+#endif
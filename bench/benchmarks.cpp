@@ -0,0 +1,596 @@
+// Microbenchmarks for the simulation, draft, reporting and lookup hot paths.
+//
+// Usage: sports_manager_bench [--scales 10,1000,100000] [--filter text] [--min-time seconds] [--out file]
+// Results are written as JSON so runs can be compared before and after a change.
+
+#define SPORTS_MANAGER_NO_MAIN
+#include "../SportsTeamManager.cpp"
+
+#include <chrono>
+
+namespace {
+
+// Accumulates timed sections; setup code outside start()/stop() is not measured
+class Timer {
+private:
+    std::chrono::steady_clock::time_point started;
+    double elapsed = 0.0;
+
+public:
+    void start() { started = std::chrono::steady_clock::now(); }
+    void stop() {
+        elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+    }
+    double nanoseconds() const { return elapsed; }
+};
+
+struct BenchResult {
+    std::string name;
+    int scale;
+    size_t repetitions;
+    size_t operations;
+    double nanoseconds;
+};
+
+struct Options {
+    std::vector<int> scales = {10, 1000, 100000};
+    std::string filter;
+    double minTime = 0.2;
+    std::string output;
+};
+
+std::ostream& discard() {
+    static std::ostream stream(nullptr);
+    return stream;
+}
+
+const Position POSITIONS[] = {
+    Position::QUARTERBACK, Position::RUNNING_BACK, Position::WIDE_RECEIVER,
+    Position::TIGHT_END, Position::KICKER, Position::DEFENSE
+};
+
+// League with `teams` teams, each owning `rosterSize` drafted players (default: one full
+// lineup) with the first `lineupSize` in the lineup, plus `extraPlayers` undrafted players
+League* buildLeague(int teams, int lineupSize, int extraPlayers, bool draft, int rosterSize = 0) {
+    rosterSize = std::max(rosterSize, lineupSize);
+    League* league = new League("Bench League", teams, rosterSize, lineupSize, false);
+    league->setMessageStream(discard());
+    league->setSeed(12345);
+    
+    int players = teams * rosterSize + extraPlayers;
+    for (int id = 1; id <= players; ++id) {
+        league->addAvailablePlayer(id, "Player " + std::to_string(id), POSITIONS[id % POSITION_COUNT],
+                                   "Club " + std::to_string(id % 32));
+    }
+    for (int t = 0; t < teams; ++t) {
+        league->registerTeam("Team " + std::to_string(t), "Owner " + std::to_string(t));
+    }
+    if (draft) {
+        std::vector<int> lineup(lineupSize);
+        for (int t = 0; t < teams; ++t) {
+            Team* team = league->getTeam(t);
+            for (int pick = 0; pick < rosterSize; ++pick) {
+                league->draftPlayer(team, t * rosterSize + pick + 1);
+            }
+            for (int slot = 0; slot < lineupSize; ++slot) {
+                lineup[slot] = t * rosterSize + slot + 1;
+            }
+            league->setTeamLineup(team, lineup);
+        }
+    }
+    return league;
+}
+
+class BenchmarkSuite {
+private:
+    Options options;
+    std::vector<BenchResult> results;
+    // Folds measured results into the output so the optimizer cannot drop the work
+    double benchmarkSink = 0.0;
+    
+    // Run body until at least minTime of measured work; body returns the operations it timed
+    template <typename Body>
+    void run(const std::string& name, int scale, Body body) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            return;
+        }
+        Timer timer;
+        size_t repetitions = 0;
+        size_t operations = 0;
+        while (repetitions == 0 || timer.nanoseconds() < options.minTime * 1e9) {
+            operations += body(timer);
+            repetitions++;
+        }
+        results.push_back({name, scale, repetitions, operations, timer.nanoseconds()});
+        std::cerr << std::left << std::setw(36) << name << std::setw(8) << scale
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(14)
+                  << timer.nanoseconds() / static_cast<double>(operations) << " ns/op\n";
+    }
+    
+    void playerBenchmarks(int scale) {
+        for (Position position : POSITIONS) {
+            std::vector<std::unique_ptr<Player>> players;
+            std::string club = "Club";
+            for (int i = 0; i < scale; ++i) {
+                players.push_back(std::make_unique<Player>(i + 1, "Player", position, &club));
+            }
+            run("player_simulate/" + positionToString(position), scale, [&](Timer& timer) {
+                timer.start();
+                for (auto& player : players) {
+                    player->simulateGamePerformance();
+                }
+                timer.stop();
+                return players.size();
+            });
+        }
+        
+        // Fitting a model from imported season totals builds its sampling tables
+        StatLine totals{};
+        totals[STAT_RUSHING_YARDS] = 1500;
+        totals[STAT_RUSHING_TDS] = 12;
+        totals[STAT_RECEIVING_YARDS] = 400;
+        totals[STAT_RECEIVING_TDS] = 3;
+        totals[STAT_RECEPTIONS] = 50;
+        run("stat_model_fit", scale, [&](Timer& timer) {
+            double mean = 0.0;
+            timer.start();
+            for (int i = 0; i < scale; ++i) {
+                mean += StatModel::fit(Position::RUNNING_BACK, 10 + i % 8, totals)->getMean(0);
+            }
+            timer.stop();
+            benchmarkSink += mean;
+            return static_cast<size_t>(scale);
+        });
+    }
+    
+    void simulationBenchmarks(int scale) {
+        int teams = std::max(2, scale);
+        std::unique_ptr<League> league(buildLeague(teams, 5, 0, true));
+        
+        run("team_simulate_game", scale, [&](Timer& timer) {
+            timer.start();
+            double total = 0.0;
+            for (int t = 0; t < teams; ++t) {
+                total += league->getTeam(t)->simulateGame();
+            }
+            timer.stop();
+            benchmarkSink += total;
+            return static_cast<size_t>(teams);
+        });
+        
+        // The same games played as one batch, grouped by position
+        LineupBatch batch;
+        run("lineup_batch_simulate", scale, [&](Timer& timer) {
+            timer.start();
+            batch.clear();
+            for (int t = 0; t < teams; ++t) {
+                batch.beginGame(static_cast<uint64_t>(t));
+                batch.addLineup(league->getTeam(t)->getActiveLineup());
+            }
+            batch.simulate(league->getScoringRules());
+            double total = 0.0;
+            for (int t = 0; t < teams; ++t) {
+                total += batch.score(static_cast<size_t>(t));
+            }
+            batch.recordGames();
+            timer.stop();
+            benchmarkSink += total;
+            return static_cast<size_t>(teams);
+        });
+        
+        run("generate_matchups", scale, [&](Timer& timer) {
+            timer.start();
+            league->generateMatchups();
+            timer.stop();
+            return static_cast<size_t>(teams);
+        });
+        
+        run("season_schedule_build", scale, [&](Timer& timer) {
+            const int weeks = 17;
+            timer.start();
+            SeasonSchedule schedule = SeasonSchedule::build(teams, weeks, 99);
+            timer.stop();
+            benchmarkSink += schedule.week(weeks - 1).size();
+            return static_cast<size_t>(teams) * weeks;
+        });
+        
+        run("matchup_simulate", scale, [&](Timer& timer) {
+            league->generateMatchups();
+            timer.start();
+            for (Matchup* matchup : league->getSchedule()) {
+                matchup->simulate();
+            }
+            timer.stop();
+            return league->getSchedule().size();
+        });
+        
+        run("simulate_week", scale, [&](Timer& timer) {
+            league->generateMatchups();
+            timer.start();
+            league->simulateWeek();
+            timer.stop();
+            return league->getSchedule().size();
+        });
+        
+        run("simulate_week_traced", scale, [&](Timer& timer) {
+            league->generateMatchups();
+            Trace::enable(true);
+            timer.start();
+            league->simulateWeek();
+            timer.stop();
+            Trace::enable(false);
+            return league->getSchedule().size();
+        });
+        
+        TextReportWriter report;
+        run("display_standings", scale, [&](Timer& timer) {
+            timer.start();
+            league->displayStandings(report);
+            timer.stop();
+            report.flush(discard());
+            return static_cast<size_t>(teams);
+        });
+        
+        Random::Engine rng(7);
+        Random::IntRange teamPick(0, teams - 1);
+        run("standings_update", scale, [&](Timer& timer) {
+            const size_t updates = 10000;
+            timer.start();
+            for (size_t i = 0; i < updates; ++i) {
+                league->getTeam(teamPick(rng))->recordGame(rng() & 1, 0.0);
+            }
+            timer.stop();
+            return updates;
+        });
+    }
+    
+    void lineupBenchmarks(int scale) {
+        int teams = std::max(2, scale / 10);
+        std::unique_ptr<League> league(buildLeague(teams, 9, 0, true, 16));
+        
+        run("optimize_all_lineups", scale, [&](Timer& timer) {
+            timer.start();
+            size_t optimized = league->optimizeAllLineups();
+            timer.stop();
+            benchmarkSink += static_cast<double>(optimized);
+            return static_cast<size_t>(teams);
+        });
+    }
+    
+    void mockDraftBenchmarks(int scale) {
+        // 12 teams drafting 16-player rosters from a pool of `scale` players (at least 192)
+        int poolSize = std::max(12 * 16, scale);
+        std::unique_ptr<League> league(buildLeague(12, 9, poolSize - 12 * 16, false, 16));
+        AutoDraft draft(*league);
+        draft.setJitter(2.0, 99);
+        std::vector<AutoDraft::Pick> picks;
+        
+        run("mock_draft_12x16", scale, [&](Timer& timer) {
+            const size_t drafts = 100;
+            timer.start();
+            for (size_t i = 0; i < drafts; ++i) {
+                picks.clear();
+                draft.mock(picks);
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(picks.size());
+            return drafts;
+        });
+    }
+    
+    void tradeBenchmarks(int scale) {
+        // 12 drafted teams with 16-player rosters; `scale` is the number of trades evaluated
+        std::unique_ptr<League> league(buildLeague(12, 9, 0, true, 16));
+        
+        run("trade_analyzer_build", scale, [&](Timer& timer) {
+            timer.start();
+            TradeAnalyzer analyzer(*league);
+            timer.stop();
+            benchmarkSink += analyzer.outlook(league->getTeam(0)).expectedWins;
+            return static_cast<size_t>(1);
+        });
+        
+        TradeAnalyzer analyzer(*league);
+        Random::Engine rng(17);
+        Random::IntRange teamPick(1, 11);
+        Random::IntRange rosterPick(0, 15);
+        std::vector<int> gives(1), receives(1);
+        run("trade_evaluate", scale, [&](Timer& timer) {
+            size_t valid = 0;
+            timer.start();
+            for (int i = 0; i < scale; ++i) {
+                Team* partner = league->getTeam(teamPick(rng));
+                gives[0] = league->getTeam(0)->getRoster()[rosterPick(rng)]->getId();
+                receives[0] = partner->getRoster()[rosterPick(rng)]->getId();
+                valid += analyzer.evaluate(league->getTeam(0), gives, partner, receives).valid;
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(valid);
+            return static_cast<size_t>(scale);
+        });
+    }
+    
+    void draftBenchmarks(int scale) {
+        int teams = std::max(2, scale / 10);
+        int rosterSize = 10;
+        
+        run("draft_player", scale, [&](Timer& timer) {
+            std::unique_ptr<League> league(buildLeague(teams, rosterSize, scale, false));
+            // Take every player in id order, round-robin over the teams
+            int drafted = 0;
+            timer.start();
+            for (int id = 1; id <= teams * rosterSize; ++id) {
+                drafted += league->draftPlayer(league->getTeam((id - 1) % teams), id);
+            }
+            timer.stop();
+            return static_cast<size_t>(drafted);
+        });
+        
+        // The same picks with every one appended to a write-ahead journal
+        std::string journal = "sports_manager_bench.journal";
+        run("draft_player_journaled", scale, [&](Timer& timer) {
+            std::unique_ptr<League> league(buildLeague(teams, rosterSize, scale, false));
+            league->startJournal(journal);
+            int drafted = 0;
+            timer.start();
+            for (int id = 1; id <= teams * rosterSize; ++id) {
+                drafted += league->draftPlayer(league->getTeam((id - 1) % teams), id);
+            }
+            timer.stop();
+            league->syncJournal();
+            return static_cast<size_t>(drafted);
+        });
+        std::remove(journal.c_str());
+        std::remove((journal + ".log").c_str());
+    }
+    
+    void historyBenchmarks(int scale) {
+        const int weeks = 17;
+        std::string club = "Club";
+        std::vector<std::unique_ptr<Player>> players;
+        for (int i = 0; i < scale; ++i) {
+            players.push_back(std::make_unique<Player>(i + 1, "Player", POSITIONS[i % POSITION_COUNT], &club));
+        }
+        
+        // Every player plays every week; only the capture is timed
+        std::unique_ptr<StatHistory> history;
+        auto fillHistory = [&](Timer* timer) {
+            history = std::make_unique<StatHistory>();
+            for (auto& player : players) {
+                history->track(player.get());
+            }
+            for (int week = 1; week <= weeks; ++week) {
+                for (auto& player : players) {
+                    player->simulateGamePerformance();
+                }
+                if (timer) {
+                    timer->start();
+                }
+                history->capture(week);
+                if (timer) {
+                    timer->stop();
+                }
+            }
+        };
+        fillHistory(nullptr);
+        run("history_capture_week", scale, [&](Timer& timer) {
+            fillHistory(&timer);
+            return players.size() * weeks;
+        });
+        
+        run("history_top_k_range", scale, [&](Timer& timer) {
+            timer.start();
+            std::vector<StatHistory::Leader> leaders = history->top(10, 5, 12);
+            timer.stop();
+            benchmarkSink += leaders.empty() ? 0.0 : leaders.front().points;
+            return players.size();
+        });
+        
+        ScoringRules ppr;
+        ScoringRules::preset("ppr", ppr);
+        run("history_rescore_season", scale, [&](Timer& timer) {
+            timer.start();
+            std::vector<StatHistory::Leader> rescored = history->rescore(ppr);
+            timer.stop();
+            benchmarkSink += rescored.front().points;
+            return players.size() * weeks;
+        });
+        
+        Random::Engine rng(13);
+        Random::IntRange playerPick(1, scale);
+        Random::IntRange weekPick(1, weeks);
+        run("history_points_range", scale, [&](Timer& timer) {
+            const size_t lookups = 100000;
+            timer.start();
+            double total = 0.0;
+            for (size_t i = 0; i < lookups; ++i) {
+                int from = weekPick(rng);
+                total += history->points(playerPick(rng), from, from + 3);
+            }
+            timer.stop();
+            benchmarkSink += total;
+            return lookups;
+        });
+    }
+    
+    void lookupBenchmarks(int scale) {
+        int teams = std::max(2, scale / 10);
+        std::unique_ptr<League> league(buildLeague(teams, 5, scale, true));
+        int players = league->getMaxPlayerId();
+        const size_t lookups = 100000;
+        
+        Random::Engine rng(11);
+        Random::IntRange playerPick(1, players);
+        Random::IntRange teamPick(0, teams - 1);
+        
+        run("lookup_player_by_id", scale, [&](Timer& timer) {
+            timer.start();
+            size_t found = 0;
+            for (size_t i = 0; i < lookups; ++i) {
+                found += league->getPlayerById(playerPick(rng)) != nullptr;
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(found);
+            return lookups;
+        });
+        
+        run("lookup_available_player", scale, [&](Timer& timer) {
+            timer.start();
+            size_t found = 0;
+            for (size_t i = 0; i < lookups; ++i) {
+                found += league->getAvailablePlayerById(playerPick(rng)) != nullptr;
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(found);
+            return lookups;
+        });
+        
+        std::vector<std::string> names;
+        for (int t = 0; t < teams; ++t) {
+            names.push_back(league->getTeam(t)->getName());
+        }
+        run("lookup_team_by_name", scale, [&](Timer& timer) {
+            timer.start();
+            size_t found = 0;
+            for (size_t i = 0; i < lookups; ++i) {
+                found += league->getTeamByName(names[teamPick(rng)]) != nullptr;
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(found);
+            return lookups;
+        });
+        
+        run("lookup_roster_player", scale, [&](Timer& timer) {
+            timer.start();
+            size_t found = 0;
+            for (size_t i = 0; i < lookups; ++i) {
+                found += league->getTeam(teamPick(rng))->getPlayerById(playerPick(rng)) != nullptr;
+            }
+            timer.stop();
+            benchmarkSink += static_cast<double>(found);
+            return lookups;
+        });
+    }
+
+    void registryBenchmarks(int scale) {
+        // One hosted league per ten units of scale, four teams of five players each
+        int leagueCount = std::max(1, scale / 10);
+        LeagueRegistry registry;
+        for (int i = 0; i < leagueCount; ++i) {
+            LeagueRegistry::LeagueId id = registry.createLeague("League " + std::to_string(i), 4, 5, 5, false);
+            registry.execute(id, [i](League& league) {
+                league.setSeed(static_cast<uint64_t>(i));
+                for (int t = 0; t < 4; ++t) {
+                    league.registerTeam("Team " + std::to_string(t), "Owner");
+                }
+                std::vector<int> lineup(5);
+                for (int player = 1; player <= 20; ++player) {
+                    league.addAvailablePlayer(player, "Player", POSITIONS[player % POSITION_COUNT], "Club");
+                }
+                for (int t = 0; t < 4; ++t) {
+                    for (int slot = 0; slot < 5; ++slot) {
+                        lineup[slot] = t * 5 + slot + 1;
+                        league.draftPlayer(league.getTeam(t), lineup[slot]);
+                    }
+                    league.setTeamLineup(league.getTeam(t), lineup);
+                }
+            });
+        }
+        registry.drain();
+        
+        run("registry_simulate_week_all", scale, [&](Timer& timer) {
+            timer.start();
+            size_t simulated = registry.simulateWeekAll();
+            timer.stop();
+            return simulated;
+        });
+    }
+
+public:
+    explicit BenchmarkSuite(const Options& options) : options(options) {}
+    
+    void runAll() {
+        for (int scale : options.scales) {
+            playerBenchmarks(scale);
+            simulationBenchmarks(scale);
+            lineupBenchmarks(scale);
+            draftBenchmarks(scale);
+            mockDraftBenchmarks(scale);
+            tradeBenchmarks(scale);
+            lookupBenchmarks(scale);
+            historyBenchmarks(scale);
+            registryBenchmarks(scale);
+        }
+    }
+    
+    std::string toJson() const {
+        std::string out;
+        JsonWriter json(out);
+        json.beginObject()
+            .field("threads", static_cast<int>(std::thread::hardware_concurrency()))
+            .key("benchmarks").beginArray();
+        for (const BenchResult& result : results) {
+            double perOp = result.nanoseconds / static_cast<double>(result.operations);
+            json.beginObject()
+                .field("name", result.name)
+                .field("scale", result.scale)
+                .field("repetitions", result.repetitions)
+                .field("operations", result.operations)
+                .field("ns_per_op", perOp)
+                .key("ops_per_sec").value(1e9 / perOp, 0)
+                .endObject();
+        }
+        json.endArray().field("checksum", benchmarkSink).endObject();
+        out += '\n';
+        return out;
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--scales" && i + 1 < argc) {
+            options.scales.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                options.scales.push_back(std::stoi(item));
+            }
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minTime = std::stod(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    
+    BenchmarkSuite suite(options);
+    suite.runAll();
+    
+    std::string json = suite.toJson();
+    if (options.output.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file(options.output);
+        file << json;
+        if (!file) {
+            std::cerr << "Cannot write " << options.output << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}